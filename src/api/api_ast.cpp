@@ -745,6 +745,7 @@ extern "C" {
         bool     use_ctrl_c  = p.get_bool("ctrl_c", false);
         th_rewriter m_rw(m, p);
         m_rw.set_solver(alloc(api::seq_expr_solver, m, p));
+        m_rw.set_memo(&mk_c(c)->simplify_memo());
         expr_ref    result(m);
         cancel_eh<reslimit> eh(m.limit());
         api::context::set_interruptable si(*(mk_c(c)), eh);
@@ -16,12 +16,15 @@ Revision History:
 
 --*/
 #include<iostream>
+#include<fstream>
+#include<sstream>
 #include "api/z3.h"
 #include "api/api_log_macros.h"
 #include "api/api_context.h"
 #include "api/api_ast_vector.h"
 #include "ast/ast_translation.h"
 #include "ast/ast_smt2_pp.h"
+#include "ast/ast_serialize.h"
 
 extern "C" {
 
@@ -136,4 +139,68 @@ extern "C" {
         Z3_CATCH_RETURN(nullptr);
     }
 
+    Z3_char_ptr Z3_API Z3_ast_vector_to_binary(Z3_context c, Z3_ast_vector v, unsigned* length) {
+        Z3_TRY;
+        LOG_Z3_ast_vector_to_binary(c, v, length);
+        RESET_ERROR_CODE();
+        if (!length) {
+            SET_ERROR_CODE(Z3_INVALID_ARG, "length argument is null");
+            return "";
+        }
+        ast_ref_vector const & asts = to_ast_vector_ref(v);
+        std::ostringstream buffer;
+        serialize(mk_c(c)->m(), asts.size(), asts.c_ptr(), buffer);
+        std::string s = buffer.str();
+        *length = static_cast<unsigned>(s.size());
+        return mk_c(c)->mk_external_string(std::move(s));
+        Z3_CATCH_RETURN("");
+    }
+
+    static Z3_ast_vector ast_vector_from_binary(Z3_context c, std::istream & in) {
+        Z3_ast_vector_ref * v = alloc(Z3_ast_vector_ref, *mk_c(c), mk_c(c)->m());
+        mk_c(c)->save_object(v);
+        deserialize(mk_c(c)->m(), in, v->m_ast_vector);
+        return of_ast_vector(v);
+    }
+
+    Z3_ast_vector Z3_API Z3_ast_vector_from_binary(Z3_context c, unsigned length, Z3_string data) {
+        Z3_TRY;
+        LOG_Z3_ast_vector_from_binary(c, length, data);
+        RESET_ERROR_CODE();
+        std::istringstream in(std::string(data, length));
+        Z3_ast_vector r = ast_vector_from_binary(c, in);
+        RETURN_Z3(r);
+        Z3_CATCH_RETURN(nullptr);
+    }
+
+    void Z3_API Z3_ast_vector_to_binary_file(Z3_context c, Z3_ast_vector v, Z3_string file_name) {
+        Z3_TRY;
+        LOG_Z3_ast_vector_to_binary_file(c, v, file_name);
+        RESET_ERROR_CODE();
+        std::ofstream out(file_name, std::ios::binary);
+        if (!out) {
+            SET_ERROR_CODE(Z3_FILE_ACCESS_ERROR, nullptr);
+            return;
+        }
+        ast_ref_vector const & asts = to_ast_vector_ref(v);
+        serialize(mk_c(c)->m(), asts.size(), asts.c_ptr(), out);
+        if (!out)
+            SET_ERROR_CODE(Z3_FILE_ACCESS_ERROR, nullptr);
+        Z3_CATCH;
+    }
+
+    Z3_ast_vector Z3_API Z3_ast_vector_from_binary_file(Z3_context c, Z3_string file_name) {
+        Z3_TRY;
+        LOG_Z3_ast_vector_from_binary_file(c, file_name);
+        RESET_ERROR_CODE();
+        std::ifstream in(file_name, std::ios::binary);
+        if (!in) {
+            SET_ERROR_CODE(Z3_FILE_ACCESS_ERROR, nullptr);
+            return nullptr;
+        }
+        Z3_ast_vector r = ast_vector_from_binary(c, in);
+        RETURN_Z3(r);
+        Z3_CATCH_RETURN(nullptr);
+    }
+
 };
@@ -32,6 +32,7 @@ Revision History:
 #include "ast/recfun_decl_plugin.h"
 #include "ast/special_relations_decl_plugin.h"
 #include "ast/rewriter/seq_rewriter.h"
+#include "ast/rewriter/rewrite_memo.h"
 #include "smt/params/smt_params.h"
 #include "smt/smt_kernel.h"
 #include "smt/smt_solver.h"
@@ -95,6 +96,8 @@ namespace api {
         ast_ref_vector             m_last_result; //!< used when m_user_ref_count == true
         ast_ref_vector             m_ast_trail;   //!< used when m_user_ref_count == false
 
+        scoped_ptr<rewrite_memo>   m_simplify_memo; //!< rewrite results shared by calls to Z3_simplify
+
         ref<api::object>           m_last_obj; //!< reference to the last API object returned by the APIs
         u_map<api::object*>        m_allocated_objects; // !< table containing current set of allocated API objects
         unsigned_vector            m_free_object_ids;   // !< free list of identifiers available for allocated objects.
@@ -200,6 +203,12 @@ namespace api {
 
         // "Save" an AST that will exposed to the "external" world.
         void save_ast_trail(ast * n);
+
+        rewrite_memo & simplify_memo() {
+            if (!m_simplify_memo)
+                m_simplify_memo = alloc(rewrite_memo, m(), 0);
+            return *m_simplify_memo;
+        }
         
         // Similar to previous method, but it "adds" n to the result.
         void save_multiple_ast_trail(ast * n);
@@ -16,6 +16,9 @@ Revision History:
 
 --*/
 #include<iostream>
+#include<functional>
+#include<cstring>
+#include "util/mapped_file.h"
 #include "api/z3.h"
 #include "api/api_log_macros.h"
 #include "api/api_context.h"
@@ -32,7 +35,7 @@ extern "C" {
     // ---------------
     // Support for SMTLIB2
 
-    Z3_ast_vector parse_smtlib2_stream(bool exec, Z3_context c, std::istream& is,
+    Z3_ast_vector parse_smtlib2(bool exec, Z3_context c, std::function<bool(cmd_context&)> const& parse,
                                        unsigned num_sorts,
                                        Z3_symbol const _sort_names[],
                                        Z3_sort const _sorts[],
@@ -88,7 +91,7 @@ extern "C" {
         std::stringstream errstrm;
         ctx->set_regular_stream(errstrm);
         try {
-            if (!parse_smt2_commands(*ctx.get(), is)) {
+            if (!parse(*ctx.get())) {
                 ctx = nullptr;
                 SET_ERROR_CODE(Z3_PARSER_ERROR, errstrm.str());
                 return of_ast_vector(v);
@@ -116,9 +119,9 @@ extern "C" {
                                           Z3_func_decl const decls[]) {
         Z3_TRY;
         LOG_Z3_parse_smtlib2_string(c, str, num_sorts, sort_names, sorts, num_decls, decl_names, decls);
-        std::string s(str);
-        std::istringstream is(s);
-        Z3_ast_vector r = parse_smtlib2_stream(false, c, is, num_sorts, sort_names, sorts, num_decls, decl_names, decls);
+        char const * end = str + strlen(str);
+        auto parse = [&](cmd_context& ctx) { return parse_smt2_commands(ctx, str, end); };
+        Z3_ast_vector r = parse_smtlib2(false, c, parse, num_sorts, sort_names, sorts, num_decls, decl_names, decls);
         RETURN_Z3(r);
         Z3_CATCH_RETURN(nullptr);
     }
@@ -132,12 +135,13 @@ extern "C" {
                                         Z3_func_decl const decls[]) {
         Z3_TRY;
         LOG_Z3_parse_smtlib2_string(c, file_name, num_sorts, sort_names, sorts, num_decls, decl_names, decls);
-        std::ifstream is(file_name);
-        if (!is) {
+        mapped_file f;
+        if (!f.open(file_name)) {
             SET_ERROR_CODE(Z3_FILE_ACCESS_ERROR, nullptr);
             return nullptr;
         }
-        Z3_ast_vector r = parse_smtlib2_stream(false, c, is, num_sorts, sort_names, sorts, num_decls, decl_names, decls);
+        auto parse = [&](cmd_context& ctx) { return parse_smt2_commands(ctx, f.begin(), f.end(), params_ref(), file_name); };
+        Z3_ast_vector r = parse_smtlib2(false, c, parse, num_sorts, sort_names, sorts, num_decls, decl_names, decls);
         RETURN_Z3(r);
         Z3_CATCH_RETURN(nullptr);
     }
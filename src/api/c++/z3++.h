@@ -372,6 +372,11 @@ namespace z3 {
         expr_vector parse_string(char const* s, sort_vector const& sorts, func_decl_vector const& decls);
         expr_vector parse_file(char const* s, sort_vector const& sorts, func_decl_vector const& decls);
 
+        /**
+           \brief read expressions in the binary format of expr_vector::to_binary.
+         */
+        expr_vector from_binary(std::string const& data);
+        expr_vector from_binary_file(char const* file);
 
     };
 
@@ -575,6 +580,17 @@ namespace z3 {
         iterator begin() const { return iterator(this, 0); }
         iterator end() const { return iterator(this, size()); }
         friend std::ostream & operator<<(std::ostream & out, ast_vector_tpl const & v) { out << Z3_ast_vector_to_string(v.ctx(), v); return out; }
+
+        /**
+           \brief compact binary representation that preserves sharing, see context::from_binary.
+        */
+        std::string to_binary() const {
+            unsigned n = 0;
+            Z3_char_ptr s = Z3_ast_vector_to_binary(ctx(), m_vector, &n);
+            check_error();
+            return std::string(s, n);
+        }
+        void to_binary_file(char const* file) const { Z3_ast_vector_to_binary_file(ctx(), m_vector, file); check_error(); }
     };
 
 
@@ -3518,6 +3534,17 @@ namespace z3 {
         return expr_vector(*this, r);
     }
 
+    inline expr_vector context::from_binary(std::string const& data) {
+        Z3_ast_vector r = Z3_ast_vector_from_binary(*this, static_cast<unsigned>(data.size()), data.c_str());
+        check_error();
+        return expr_vector(*this, r);
+    }
+    inline expr_vector context::from_binary_file(char const* file) {
+        Z3_ast_vector r = Z3_ast_vector_from_binary_file(*this, file);
+        check_error();
+        return expr_vector(*this, r);
+    }
+
     inline expr_vector context::parse_string(char const* s, sort_vector const& sorts, func_decl_vector const& decls) {
         array<Z3_symbol> sort_names(sorts.size());
         array<Z3_symbol> decl_names(decls.size());
@@ -104,6 +104,42 @@ extern "C" {
     */
     Z3_string Z3_API Z3_ast_vector_to_string(Z3_context c, Z3_ast_vector v);
 
+    /**
+       \brief Convert AST vector into a compact binary format that preserves sharing.
+
+       The result may contain zero bytes, and its size is stored in \c length.
+       It is valid until the next call that returns a string.
+
+       \sa Z3_ast_vector_from_binary
+
+       def_API('Z3_ast_vector_to_binary', CHAR_PTR, (_in(CONTEXT), _in(AST_VECTOR), _out(UINT)))
+    */
+    Z3_char_ptr Z3_API Z3_ast_vector_to_binary(Z3_context c, Z3_ast_vector v, unsigned* length);
+
+    /**
+       \brief Read an AST vector from the first \c length bytes of \c data,
+       which were produced by #Z3_ast_vector_to_binary.
+
+       \sa Z3_ast_vector_to_binary
+
+       def_API('Z3_ast_vector_from_binary', AST_VECTOR, (_in(CONTEXT), _in(UINT), _in(STRING)))
+    */
+    Z3_ast_vector Z3_API Z3_ast_vector_from_binary(Z3_context c, unsigned length, Z3_string data);
+
+    /**
+       \brief Write AST vector to a file in the format of #Z3_ast_vector_to_binary.
+
+       def_API('Z3_ast_vector_to_binary_file', VOID, (_in(CONTEXT), _in(AST_VECTOR), _in(STRING)))
+    */
+    void Z3_API Z3_ast_vector_to_binary_file(Z3_context c, Z3_ast_vector v, Z3_string file_name);
+
+    /**
+       \brief Read an AST vector from a file written by #Z3_ast_vector_to_binary_file.
+
+       def_API('Z3_ast_vector_from_binary_file', AST_VECTOR, (_in(CONTEXT), _in(STRING)))
+    */
+    Z3_ast_vector Z3_API Z3_ast_vector_from_binary_file(Z3_context c, Z3_string file_name);
+
     /*@}*/
 
     /** @name AST maps */
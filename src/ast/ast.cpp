@@ -1436,6 +1436,8 @@ void ast_manager::update_fresh_id(ast_manager const& m) {
 void ast_manager::init() {
     m_int_real_coercions = true;
     m_debug_ref_count = false;
+    m_frozen = false;
+    m_del_budget = 0;
     m_fresh_id = 0;
     m_expr_id_gen.reset(0);
     m_decl_id_gen.reset(c_first_decl_id);
@@ -1483,6 +1485,7 @@ static void mark_array_ref(ast_mark& mark, unsigned sz, parameter const * a) {
 
 ast_manager::~ast_manager() {
     SASSERT(is_format_manager() || !m_family_manager.has_family(symbol("format")));
+    set_del_budget(0);
 
     dec_ref(m_bool_sort);
     dec_ref(m_proof_sort);
@@ -1796,6 +1799,7 @@ static void track_id(ast_manager& m, ast* n, unsigned id) {
 #endif
 
 ast * ast_manager::register_node_core(ast * n) {
+    SASSERT(!m_frozen);
     unsigned h = get_node_hash(n);
     n->m_hash = h;
 #ifdef Z3DEBUG
@@ -1917,74 +1921,129 @@ ast * ast_manager::register_node_core(ast * n) {
 void ast_manager::delete_node(ast * n) {
     TRACE("delete_node_bug", tout << mk_ll_pp(n, *this) << "\n";);
 
+    SASSERT(!m_frozen);
     SASSERT(m_ast_table.contains(n));
     m_ast_table.push_erase(n);
 
+    if (m_del_budget == 0) {
+        while ((n = m_ast_table.pop_erase()))
+            delete_node_core(n);
+        return;
+    }
+    unsigned budget = m_del_budget;
+    delete_erased(budget);
+    drain(budget);
+}
+
+/**
+   \brief delete the nodes that were erased from m_ast_table, and their
+   sub-terms that become unreferenced, with at most budget deletions.
+   The remaining erased nodes are moved to m_deferred.
+*/
+void ast_manager::delete_erased(unsigned & budget) {
+    ast * n;
     while ((n = m_ast_table.pop_erase())) {
+        if (budget == 0) {
+            m_deferred.push_back(n);
+            m_del_stats.m_num_deferred++;
+            continue;
+        }
+        --budget;
+        delete_node_core(n);
+    }
+    m_del_stats.m_max_deferred = std::max(m_del_stats.m_max_deferred, m_deferred.size());
+}
+
+bool ast_manager::drain(unsigned budget) {
+    while (budget > 0 && !m_deferred.empty()) {
+        ast * n = m_deferred.back();
+        m_deferred.pop_back();
+        m_del_stats.m_num_drained++;
+        --budget;
+        delete_node_core(n);
+        delete_erased(budget);
+    }
+    return m_deferred.empty();
+}
+
+void ast_manager::set_del_budget(unsigned budget) {
+    m_del_budget = budget;
+    if (budget == 0)
+        drain();
+}
+
+void ast_manager::collect_statistics(statistics & st) const {
+    m_alloc.collect_statistics(st);
+    if (m_del_budget == 0 && m_del_stats.m_num_deferred == 0)
+        return;
+    st.update("ast deferred deletions", m_del_stats.m_num_deferred);
+    st.update("ast drained deletions", m_del_stats.m_num_drained);
+    st.update("ast max deferred", m_del_stats.m_max_deferred);
+}
 
-        CTRACE("del_quantifier", is_quantifier(n), tout << "deleting quantifier " << n->m_id << " " << n << "\n";);
-        TRACE("mk_var_bug", tout << "del_ast: " << " " << n->m_ref_count << "\n";);
-        TRACE("ast_delete_node", tout << mk_bounded_pp(n, *this) << "\n";);
+void ast_manager::delete_node_core(ast * n) {
+    CTRACE("del_quantifier", is_quantifier(n), tout << "deleting quantifier " << n->m_id << " " << n << "\n";);
+    TRACE("mk_var_bug", tout << "del_ast: " << " " << n->m_ref_count << "\n";);
+    TRACE("ast_delete_node", tout << mk_bounded_pp(n, *this) << "\n";);
 
-        SASSERT(!m_debug_ref_count || !m_debug_free_indices.contains(n->m_id));
+    SASSERT(!m_debug_ref_count || !m_debug_free_indices.contains(n->m_id));
 
 #ifdef RECYCLE_FREE_AST_INDICES
-        if (!m_debug_ref_count) {
-            if (is_decl(n))
-                m_decl_id_gen.recycle(n->m_id);
-            else
-                m_expr_id_gen.recycle(n->m_id);
-        }
+    if (!m_debug_ref_count) {
+        if (is_decl(n))
+            m_decl_id_gen.recycle(n->m_id);
+        else
+            m_expr_id_gen.recycle(n->m_id);
+    }
 #endif
-        switch (n->get_kind()) {
-        case AST_SORT:
-            if (to_sort(n)->m_info != nullptr && !m_debug_ref_count) {
-                sort_info * info = to_sort(n)->get_info();
-                info->del_eh(*this);
-                dealloc(info);
-            }
-            break;
-        case AST_FUNC_DECL: {
-            func_decl* f = to_func_decl(n);
-            if (f->m_info != nullptr && !m_debug_ref_count) {
-                func_decl_info * info = f->get_info();
-                if (info->is_lambda()) {
-                    push_dec_ref(m_lambda_defs[f]);
-                    m_lambda_defs.remove(f);
-                }
-                info->del_eh(*this);
-                dealloc(info);
-            }
-            push_dec_array_ref(f->get_arity(), f->get_domain());
-            push_dec_ref(f->get_range());
-            break;
-        }
-        case AST_APP: {
-            app* a = to_app(n);
-            push_dec_ref(a->get_decl());
-            push_dec_array_ref(a->get_num_args(), a->get_args());
-            break;
-        }
-        case AST_VAR:
-            push_dec_ref(to_var(n)->get_sort());
-            break;
-        case AST_QUANTIFIER: {
-            quantifier* q = to_quantifier(n);
-            push_dec_array_ref(q->get_num_decls(), q->get_decl_sorts());
-            push_dec_ref(q->get_expr());
-            push_dec_ref(q->get_sort());
-            push_dec_array_ref(q->get_num_patterns(), q->get_patterns());
-            push_dec_array_ref(q->get_num_no_patterns(), q->get_no_patterns());
-            break;
+    switch (n->get_kind()) {
+    case AST_SORT:
+        if (to_sort(n)->m_info != nullptr && !m_debug_ref_count) {
+            sort_info * info = to_sort(n)->get_info();
+            info->del_eh(*this);
+            dealloc(info);
         }
-        default:
-            break;
+        break;
+    case AST_FUNC_DECL: {
+        func_decl* f = to_func_decl(n);
+        if (f->m_info != nullptr && !m_debug_ref_count) {
+            func_decl_info * info = f->get_info();
+            if (info->is_lambda()) {
+                push_dec_ref(m_lambda_defs[f]);
+                m_lambda_defs.remove(f);
+            }
+            info->del_eh(*this);
+            dealloc(info);
         }
-        if (m_debug_ref_count) {
-            m_debug_free_indices.insert(n->m_id,0);
-        }       
-        deallocate_node(n, ::get_node_size(n));
+        push_dec_array_ref(f->get_arity(), f->get_domain());
+        push_dec_ref(f->get_range());
+        break;
+    }
+    case AST_APP: {
+        app* a = to_app(n);
+        push_dec_ref(a->get_decl());
+        push_dec_array_ref(a->get_num_args(), a->get_args());
+        break;
+    }
+    case AST_VAR:
+        push_dec_ref(to_var(n)->get_sort());
+        break;
+    case AST_QUANTIFIER: {
+        quantifier* q = to_quantifier(n);
+        push_dec_array_ref(q->get_num_decls(), q->get_decl_sorts());
+        push_dec_ref(q->get_expr());
+        push_dec_ref(q->get_sort());
+        push_dec_array_ref(q->get_num_patterns(), q->get_patterns());
+        push_dec_array_ref(q->get_num_no_patterns(), q->get_no_patterns());
+        break;
+    }
+    default:
+        break;
     }
+    if (m_debug_ref_count) {
+        m_debug_free_indices.insert(n->m_id,0);
+    }       
+    deallocate_node(n, ::get_node_size(n));
 }
 
 
@@ -46,6 +46,7 @@ Revision History:
 #include "util/z3_exception.h"
 #include "util/dependency.h"
 #include "util/rlimit.h"
+#include "util/statistics.h"
 
 #define RECYCLE_FREE_AST_INDICES
 
@@ -1543,6 +1544,16 @@ protected:
     proof *                   m_undef_proof;
     unsigned                  m_fresh_id;
     bool                      m_debug_ref_count;
+    bool                      m_frozen;
+    unsigned                  m_del_budget;
+    ptr_vector<ast>           m_deferred;   // unreferenced nodes whose deletion was postponed
+    struct del_stats {
+        unsigned m_num_deferred;
+        unsigned m_num_drained;
+        unsigned m_max_deferred;
+        del_stats() { memset(this, 0, sizeof(*this)); }
+    };
+    del_stats                 m_del_stats;
     u_map<unsigned>           m_debug_free_indices;
     std::fstream*             m_trace_stream;
     bool                      m_trace_stream_owner;
@@ -1679,6 +1690,31 @@ public:
 
     void debug_ref_count() { m_debug_ref_count = true; }
 
+    /**
+       \brief A frozen manager neither creates nor deletes terms.
+       Its terms can then be read concurrently by translations into other managers,
+       which do not update reference counts of terms in a frozen manager.
+     */
+    void set_frozen(bool f) { m_frozen = f; }
+    bool is_frozen() const { return m_frozen; }
+
+    /**
+       \brief bound the number of nodes deleted when a reference count drops to zero.
+       The remaining unreferenced nodes are deferred, and deleted by later
+       deletions or by drain(). The default budget 0 deletes nodes eagerly.
+     */
+    void set_del_budget(unsigned budget);
+    unsigned get_del_budget() const { return m_del_budget; }
+
+    /**
+       \brief delete deferred nodes with at most budget deletions.
+       Return true if no deferred nodes remain.
+     */
+    bool drain(unsigned budget = UINT_MAX);
+    unsigned get_num_deferred() const { return m_deferred.size(); }
+
+    void collect_statistics(statistics & st) const;
+
     void inc_ref(ast* n) {
         if (n) {
             n->inc_ref();
@@ -1724,6 +1760,8 @@ protected:
     }
 
     void delete_node(ast * n);
+    void delete_erased(unsigned & budget);
+    void delete_node_core(ast * n);
 
     void * allocate_node(unsigned size) {
         return m_alloc.allocate(size);
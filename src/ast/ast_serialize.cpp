@@ -0,0 +1,639 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    ast_serialize.cpp
+
+Abstract:
+
+    Compact binary serialization of ASTs.
+
+--*/
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include "ast/ast_serialize.h"
+
+static char const     g_magic[4]  = { 'Z', '3', 'A', 'B' };
+static const unsigned g_version   = 1;
+
+enum binary_tag {
+    TAG_END = 0,
+    TAG_ROOT,
+    TAG_FAMILY,
+    TAG_SORT,
+    TAG_FUNC_DECL,
+    TAG_APP,
+    TAG_VAR,
+    TAG_QUANTIFIER
+};
+
+enum binary_decl_flag {
+    FLAG_LEFT_ASSOC   = 1,
+    FLAG_RIGHT_ASSOC  = 2,
+    FLAG_FLAT_ASSOC   = 4,
+    FLAG_COMMUTATIVE  = 8,
+    FLAG_CHAINABLE    = 16,
+    FLAG_PAIRWISE     = 32,
+    FLAG_INJECTIVE    = 64,
+    FLAG_SKOLEM       = 128,
+    FLAG_IDEMPOTENT   = 256
+};
+
+ast_binary_writer::ast_binary_writer(ast_manager & m, std::ostream & out):
+    m(m),
+    m_stream(out),
+    m_out(*out.rdbuf()),
+    m_pinned(m),
+    m_num_families(0),
+    m_finished(false) {
+    write_bytes(g_magic, sizeof(g_magic));
+    write_uint(g_version);
+}
+
+ast_binary_writer::~ast_binary_writer() {
+    finish();
+}
+
+/**
+   \brief the stream buffer is written directly, so failures are
+   reported back to the stream for the caller to check.
+*/
+void ast_binary_writer::write_byte(unsigned char b) {
+    if (m_out.sputc(static_cast<char>(b)) == std::char_traits<char>::eof())
+        m_stream.setstate(std::ios::badbit);
+}
+
+void ast_binary_writer::write_bytes(char const * s, size_t len) {
+    if (m_out.sputn(s, len) != static_cast<std::streamsize>(len))
+        m_stream.setstate(std::ios::badbit);
+}
+
+void ast_binary_writer::write_uint(uint64_t n) {
+    while (n >= 0x80) {
+        write_byte(static_cast<unsigned char>(n | 0x80));
+        n >>= 7;
+    }
+    write_byte(static_cast<unsigned char>(n));
+}
+
+void ast_binary_writer::write_int(int64_t n) {
+    write_uint((static_cast<uint64_t>(n) << 1) ^ static_cast<uint64_t>(n >> 63));
+}
+
+void ast_binary_writer::write_symbol(symbol const & s) {
+    if (s.is_null()) {
+        write_byte(0);
+    }
+    else if (s.is_numerical()) {
+        write_byte(1);
+        write_uint(s.get_num());
+    }
+    else {
+        char const * str = s.bare_str();
+        size_t len = strlen(str);
+        write_byte(2);
+        write_uint(len);
+        write_bytes(str, len);
+    }
+}
+
+/**
+   \brief datatypes and recursive functions depend on definitions that are
+   not part of the stream, so their plugins cannot rebuild the sorts and
+   declarations.
+*/
+static bool is_supported_family(ast_manager & m, family_id fid) {
+    return fid != m.get_family_id("datatype") && fid != m.get_family_id("recfun");
+}
+
+/**
+   \brief families are numbered from 1 in the order of their first use,
+   and 0 stands for null_family_id.
+   A family record is written before the first node that uses it.
+*/
+void ast_binary_writer::write_family(family_id fid) {
+    if (fid == null_family_id)
+        return;
+    unsigned idx = static_cast<unsigned>(fid);
+    if (idx >= m_family2idx.size())
+        m_family2idx.resize(idx + 1, UINT_MAX);
+    if (m_family2idx[idx] == UINT_MAX) {
+        if (!is_supported_family(m, fid))
+            throw default_exception("cannot serialize datatypes and recursive functions");
+        m_family2idx[idx] = m_num_families++;
+        write_byte(TAG_FAMILY);
+        write_symbol(m.get_family_name(fid));
+    }
+}
+
+void ast_binary_writer::write_parameters(decl * d) {
+    write_uint(d->get_num_parameters());
+    for (parameter const & p : d->parameters()) {
+        write_byte(static_cast<unsigned char>(p.get_kind()));
+        switch (p.get_kind()) {
+        case parameter::PARAM_INT:
+            write_int(p.get_int());
+            break;
+        case parameter::PARAM_AST:
+            write_ref(p.get_ast());
+            break;
+        case parameter::PARAM_SYMBOL:
+            write_symbol(p.get_symbol());
+            break;
+        case parameter::PARAM_RATIONAL: {
+            std::string s = p.get_rational().to_string();
+            write_uint(s.size());
+            write_bytes(s.c_str(), s.size());
+            break;
+        }
+        case parameter::PARAM_DOUBLE: {
+            double v = p.get_double();
+            uint64_t bits;
+            memcpy(&bits, &v, sizeof(bits));
+            for (unsigned i = 0; i < 8; ++i)
+                write_byte(static_cast<unsigned char>(bits >> (8 * i)));
+            break;
+        }
+        default:
+            throw default_exception("cannot serialize declarations with external parameters");
+        }
+    }
+}
+
+void ast_binary_writer::push_children(ast * n) {
+    auto visit = [&](ast * c) {
+        if (!m_ids.contains(c))
+            m_todo.push_back(c);
+    };
+    auto visit_params = [&](decl * d) {
+        for (parameter const & p : d->parameters())
+            if (p.is_ast())
+                visit(p.get_ast());
+    };
+    switch (n->get_kind()) {
+    case AST_SORT:
+        visit_params(to_sort(n));
+        break;
+    case AST_FUNC_DECL: {
+        func_decl * f = to_func_decl(n);
+        for (sort * s : *f)
+            visit(s);
+        visit(f->get_range());
+        visit_params(f);
+        break;
+    }
+    case AST_APP:
+        visit(to_app(n)->get_decl());
+        for (expr * arg : *to_app(n))
+            visit(arg);
+        break;
+    case AST_VAR:
+        visit(to_var(n)->get_sort());
+        break;
+    case AST_QUANTIFIER: {
+        quantifier * q = to_quantifier(n);
+        for (unsigned i = 0; i < q->get_num_decls(); ++i)
+            visit(q->get_decl_sort(i));
+        visit(q->get_expr());
+        for (unsigned i = 0; i < q->get_num_patterns(); ++i)
+            visit(q->get_pattern(i));
+        for (unsigned i = 0; i < q->get_num_no_patterns(); ++i)
+            visit(q->get_no_pattern(i));
+        break;
+    }
+    default:
+        UNREACHABLE();
+    }
+}
+
+void ast_binary_writer::write_node(ast * n) {
+    switch (n->get_kind()) {
+    case AST_SORT: {
+        sort * s = to_sort(n);
+        sort_info * si = s->get_info();
+        if (si)
+            write_family(si->get_family_id());
+        write_byte(TAG_SORT);
+        write_symbol(s->get_name());
+        write_byte(si ? 1 : 0);
+        if (si) {
+            write_uint(family_ref(si->get_family_id()));
+            write_int(si->get_decl_kind());
+            sort_size const & sz = si->get_num_elements();
+            if (sz.is_finite()) {
+                write_byte(0);
+                write_uint(sz.size());
+            }
+            else
+                write_byte(sz.is_very_big() ? 1 : 2);
+            write_byte(si->private_parameters() ? 1 : 0);
+            write_parameters(s);
+        }
+        break;
+    }
+    case AST_FUNC_DECL: {
+        func_decl * f = to_func_decl(n);
+        func_decl_info * fi = f->get_info();
+        if (fi)
+            write_family(fi->get_family_id());
+        write_byte(TAG_FUNC_DECL);
+        write_symbol(f->get_name());
+        write_uint(f->get_arity());
+        for (sort * s : *f)
+            write_ref(s);
+        write_ref(f->get_range());
+        write_byte(fi ? 1 : 0);
+        if (fi) {
+            unsigned flags = 0;
+            if (fi->is_left_associative())  flags |= FLAG_LEFT_ASSOC;
+            if (fi->is_right_associative()) flags |= FLAG_RIGHT_ASSOC;
+            if (fi->is_flat_associative())  flags |= FLAG_FLAT_ASSOC;
+            if (fi->is_commutative())       flags |= FLAG_COMMUTATIVE;
+            if (fi->is_chainable())         flags |= FLAG_CHAINABLE;
+            if (fi->is_pairwise())          flags |= FLAG_PAIRWISE;
+            if (fi->is_injective())         flags |= FLAG_INJECTIVE;
+            if (fi->is_skolem())            flags |= FLAG_SKOLEM;
+            if (fi->is_idempotent())        flags |= FLAG_IDEMPOTENT;
+            write_uint(family_ref(fi->get_family_id()));
+            write_int(fi->get_decl_kind());
+            write_uint(flags);
+            write_parameters(f);
+        }
+        break;
+    }
+    case AST_APP:
+        write_byte(TAG_APP);
+        write_ref(to_app(n)->get_decl());
+        write_uint(to_app(n)->get_num_args());
+        for (expr * arg : *to_app(n))
+            write_ref(arg);
+        break;
+    case AST_VAR:
+        write_byte(TAG_VAR);
+        write_uint(to_var(n)->get_idx());
+        write_ref(to_var(n)->get_sort());
+        break;
+    case AST_QUANTIFIER: {
+        quantifier * q = to_quantifier(n);
+        write_byte(TAG_QUANTIFIER);
+        write_byte(static_cast<unsigned char>(q->get_kind()));
+        write_uint(q->get_num_decls());
+        for (unsigned i = 0; i < q->get_num_decls(); ++i) {
+            write_symbol(q->get_decl_name(i));
+            write_ref(q->get_decl_sort(i));
+        }
+        write_ref(q->get_expr());
+        write_int(q->get_weight());
+        write_symbol(q->get_qid());
+        write_symbol(q->get_skid());
+        write_uint(q->get_num_patterns());
+        for (unsigned i = 0; i < q->get_num_patterns(); ++i)
+            write_ref(q->get_pattern(i));
+        write_uint(q->get_num_no_patterns());
+        for (unsigned i = 0; i < q->get_num_no_patterns(); ++i)
+            write_ref(q->get_no_pattern(i));
+        break;
+    }
+    default:
+        UNREACHABLE();
+    }
+    m_ids.insert(n, m_pinned.size());
+    m_pinned.push_back(n);
+}
+
+void ast_binary_writer::write(ast * n) {
+    SASSERT(!m_finished);
+    m_todo.push_back(n);
+    while (!m_todo.empty()) {
+        ast * curr = m_todo.back();
+        if (m_ids.contains(curr)) {
+            m_todo.pop_back();
+            continue;
+        }
+        unsigned sz = m_todo.size();
+        push_children(curr);
+        if (sz < m_todo.size())
+            continue;
+        m_todo.pop_back();
+        write_node(curr);
+    }
+    write_byte(TAG_ROOT);
+    write_ref(n);
+}
+
+void ast_binary_writer::finish() {
+    if (m_finished)
+        return;
+    m_finished = true;
+    write_byte(TAG_END);
+    if (m_out.pubsync() == -1)
+        m_stream.setstate(std::ios::badbit);
+}
+
+ast_binary_reader::ast_binary_reader(ast_manager & m, std::istream & in):
+    m(m),
+    m_in(*in.rdbuf()),
+    m_nodes(m),
+    m_done(false) {
+    for (char c : g_magic)
+        if (read_byte() != static_cast<unsigned char>(c))
+            throw default_exception("not a binary AST stream");
+    if (read_uint() != g_version)
+        throw default_exception("unsupported binary AST version");
+}
+
+unsigned char ast_binary_reader::read_byte() {
+    int c = m_in.sbumpc();
+    if (c == std::char_traits<char>::eof())
+        throw default_exception("unexpected end of binary AST stream");
+    return static_cast<unsigned char>(c);
+}
+
+uint64_t ast_binary_reader::read_uint() {
+    uint64_t r = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        unsigned char b = read_byte();
+        r |= static_cast<uint64_t>(b & 0x7f) << shift;
+        if (!(b & 0x80))
+            return r;
+    }
+    throw default_exception("invalid integer in binary AST stream");
+}
+
+unsigned ast_binary_reader::read_unsigned() {
+    uint64_t r = read_uint();
+    if (r > UINT_MAX)
+        throw default_exception("invalid integer in binary AST stream");
+    return static_cast<unsigned>(r);
+}
+
+int ast_binary_reader::read_int() {
+    uint64_t u = read_uint();
+    int64_t r = static_cast<int64_t>(u >> 1) ^ -static_cast<int64_t>(u & 1);
+    if (r < INT_MIN || r > INT_MAX)
+        throw default_exception("invalid integer in binary AST stream");
+    return static_cast<int>(r);
+}
+
+/**
+   \brief read a length-prefixed string.
+   The string grows with the data that is actually read, such that
+   a corrupt length does not cause a large allocation.
+*/
+void ast_binary_reader::read_string(std::string & s) {
+    unsigned len = read_unsigned();
+    char buf[4096];
+    s.clear();
+    while (len > 0) {
+        unsigned n = std::min(len, static_cast<unsigned>(sizeof(buf)));
+        if (m_in.sgetn(buf, n) != static_cast<std::streamsize>(n))
+            throw default_exception("unexpected end of binary AST stream");
+        s.append(buf, n);
+        len -= n;
+    }
+}
+
+symbol ast_binary_reader::read_symbol() {
+    switch (read_byte()) {
+    case 0:
+        return symbol::null;
+    case 1:
+        return symbol(read_unsigned());
+    case 2: {
+        std::string s;
+        read_string(s);
+        return symbol(s.c_str());
+    }
+    default:
+        throw default_exception("invalid symbol in binary AST stream");
+    }
+}
+
+ast * ast_binary_reader::read_ref() {
+    unsigned idx = read_unsigned();
+    if (idx >= m_nodes.size())
+        throw default_exception("invalid node reference in binary AST stream");
+    return m_nodes.get(idx);
+}
+
+sort * ast_binary_reader::read_sort_ref() {
+    ast * n = read_ref();
+    if (!is_sort(n))
+        throw default_exception("sort expected in binary AST stream");
+    return to_sort(n);
+}
+
+expr * ast_binary_reader::read_expr_ref() {
+    ast * n = read_ref();
+    if (!is_expr(n))
+        throw default_exception("expression expected in binary AST stream");
+    return to_expr(n);
+}
+
+family_id ast_binary_reader::read_family() {
+    unsigned idx = read_unsigned();
+    if (idx == 0)
+        return null_family_id;
+    if (idx > m_families.size())
+        throw default_exception("invalid family reference in binary AST stream");
+    return m_families[idx - 1];
+}
+
+void ast_binary_reader::read_parameters(vector<parameter> & ps) {
+    unsigned n = read_unsigned();
+    for (unsigned i = 0; i < n; ++i) {
+        switch (read_byte()) {
+        case parameter::PARAM_INT:
+            ps.push_back(parameter(read_int()));
+            break;
+        case parameter::PARAM_AST:
+            ps.push_back(parameter(read_ref()));
+            break;
+        case parameter::PARAM_SYMBOL:
+            ps.push_back(parameter(read_symbol()));
+            break;
+        case parameter::PARAM_RATIONAL: {
+            std::string s;
+            read_string(s);
+            ps.push_back(parameter(rational(s.c_str())));
+            break;
+        }
+        case parameter::PARAM_DOUBLE: {
+            uint64_t bits = 0;
+            for (unsigned j = 0; j < 8; ++j)
+                bits |= static_cast<uint64_t>(read_byte()) << (8 * j);
+            double v;
+            memcpy(&v, &bits, sizeof(v));
+            ps.push_back(parameter(v));
+            break;
+        }
+        default:
+            throw default_exception("invalid parameter in binary AST stream");
+        }
+    }
+}
+
+void ast_binary_reader::read_sort() {
+    symbol name = read_symbol();
+    sort * s;
+    if (read_byte() == 0) {
+        s = m.mk_uninterpreted_sort(name);
+    }
+    else {
+        family_id fid = read_family();
+        decl_kind k   = read_int();
+        sort_size sz;
+        switch (read_byte()) {
+        case 0:  sz = sort_size::mk_finite(read_uint()); break;
+        case 1:  sz = sort_size::mk_very_big(); break;
+        default: sz = sort_size::mk_infinite(); break;
+        }
+        bool priv = read_byte() != 0;
+        vector<parameter> ps;
+        read_parameters(ps);
+        // builtin sorts and declarations are rebuilt by their plugins.
+        if (fid == null_family_id)
+            s = m.mk_sort(name, sort_info(fid, k, sz, ps.size(), ps.c_ptr(), priv));
+        else if (fid == m.get_user_sort_family_id())
+            s = m.mk_uninterpreted_sort(name, ps.size(), ps.c_ptr());
+        else
+            s = m.mk_sort(fid, k, ps.size(), ps.c_ptr());
+    }
+    if (!s)
+        throw default_exception("invalid sort in binary AST stream");
+    m_nodes.push_back(s);
+}
+
+void ast_binary_reader::read_func_decl() {
+    symbol name = read_symbol();
+    unsigned arity = read_unsigned();
+    ptr_buffer<sort> domain;
+    for (unsigned i = 0; i < arity; ++i)
+        domain.push_back(read_sort_ref());
+    sort * range = read_sort_ref();
+    func_decl * f;
+    if (read_byte() == 0) {
+        f = m.mk_func_decl(name, arity, domain.c_ptr(), range);
+    }
+    else {
+        family_id fid  = read_family();
+        decl_kind k    = read_int();
+        unsigned flags = read_unsigned();
+        vector<parameter> ps;
+        read_parameters(ps);
+        if (fid == null_family_id) {
+            func_decl_info fi(fid, k, ps.size(), ps.c_ptr());
+            fi.set_left_associative((flags & FLAG_LEFT_ASSOC) != 0);
+            fi.set_right_associative((flags & FLAG_RIGHT_ASSOC) != 0);
+            fi.set_flat_associative((flags & FLAG_FLAT_ASSOC) != 0);
+            fi.set_commutative((flags & FLAG_COMMUTATIVE) != 0);
+            fi.set_chainable((flags & FLAG_CHAINABLE) != 0);
+            fi.set_pairwise((flags & FLAG_PAIRWISE) != 0);
+            fi.set_injective((flags & FLAG_INJECTIVE) != 0);
+            fi.set_skolem((flags & FLAG_SKOLEM) != 0);
+            fi.set_idempotent((flags & FLAG_IDEMPOTENT) != 0);
+            f = m.mk_func_decl(name, arity, domain.c_ptr(), range, fi);
+        }
+        else if (fid == m.get_user_sort_family_id())
+            f = nullptr;
+        else
+            f = m.mk_func_decl(fid, k, ps.size(), ps.c_ptr(), arity, domain.c_ptr(), range);
+    }
+    if (!f)
+        throw default_exception("invalid declaration in binary AST stream");
+    m_nodes.push_back(f);
+}
+
+void ast_binary_reader::read_app() {
+    ast * d = read_ref();
+    if (!is_func_decl(d))
+        throw default_exception("declaration expected in binary AST stream");
+    unsigned num_args = read_unsigned();
+    ptr_buffer<expr> args;
+    for (unsigned i = 0; i < num_args; ++i)
+        args.push_back(read_expr_ref());
+    m_nodes.push_back(m.mk_app(to_func_decl(d), num_args, args.c_ptr()));
+}
+
+void ast_binary_reader::read_var() {
+    unsigned idx = read_unsigned();
+    m_nodes.push_back(m.mk_var(idx, read_sort_ref()));
+}
+
+void ast_binary_reader::read_quantifier() {
+    unsigned char k = read_byte();
+    if (k != forall_k && k != exists_k && k != lambda_k)
+        throw default_exception("invalid quantifier in binary AST stream");
+    unsigned num_decls = read_unsigned();
+    buffer<symbol> names;
+    ptr_buffer<sort> sorts;
+    for (unsigned i = 0; i < num_decls; ++i) {
+        names.push_back(read_symbol());
+        sorts.push_back(read_sort_ref());
+    }
+    expr * body = read_expr_ref();
+    int weight  = read_int();
+    symbol qid  = read_symbol();
+    symbol skid = read_symbol();
+    ptr_buffer<expr> pats, no_pats;
+    unsigned num_pats = read_unsigned();
+    for (unsigned i = 0; i < num_pats; ++i)
+        pats.push_back(read_expr_ref());
+    unsigned num_no_pats = read_unsigned();
+    for (unsigned i = 0; i < num_no_pats; ++i)
+        no_pats.push_back(read_expr_ref());
+    m_nodes.push_back(m.mk_quantifier(static_cast<quantifier_kind>(k), num_decls, sorts.c_ptr(), names.c_ptr(), body,
+                                      weight, qid, skid, num_pats, pats.c_ptr(), num_no_pats, no_pats.c_ptr()));
+}
+
+ast * ast_binary_reader::read() {
+    while (!m_done) {
+        switch (read_byte()) {
+        case TAG_END:
+            m_done = true;
+            break;
+        case TAG_ROOT:
+            return read_ref();
+        case TAG_FAMILY: {
+            family_id fid = m.mk_family_id(read_symbol());
+            if (!is_supported_family(m, fid))
+                throw default_exception("unsupported family in binary AST stream");
+            m_families.push_back(fid);
+            break;
+        }
+        case TAG_SORT:
+            read_sort();
+            break;
+        case TAG_FUNC_DECL:
+            read_func_decl();
+            break;
+        case TAG_APP:
+            read_app();
+            break;
+        case TAG_VAR:
+            read_var();
+            break;
+        case TAG_QUANTIFIER:
+            read_quantifier();
+            break;
+        default:
+            throw default_exception("invalid record in binary AST stream");
+        }
+    }
+    return nullptr;
+}
+
+void serialize(ast_manager & m, unsigned num_asts, ast * const * asts, std::ostream & out) {
+    ast_binary_writer w(m, out);
+    for (unsigned i = 0; i < num_asts; ++i)
+        w.write(asts[i]);
+    w.finish();
+}
+
+void deserialize(ast_manager & m, std::istream & in, ast_ref_vector & result) {
+    ast_binary_reader r(m, in);
+    while (ast * n = r.read())
+        result.push_back(n);
+}
@@ -0,0 +1,111 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    ast_serialize.h
+
+Abstract:
+
+    Compact binary serialization of ASTs.
+
+    The format is a stream of records that define the nodes of a DAG
+    in post-order, such that shared sub-terms, sorts and declarations
+    are written once. Nodes are referenced by their position in the
+    stream, and all integers are written as LEB128 varints.
+    Theory families are written by name, such that a stream can be
+    read into a different ast_manager.
+
+    A writer can be used to stream several roots; nodes shared with
+    roots written earlier are not repeated. Builtin sorts and declarations
+    are rebuilt by their plugins when they are read. Parameters that are
+    private to a decl_plugin (PARAM_EXTERNAL), datatypes and recursive
+    functions cannot be serialized.
+
+--*/
+#pragma once
+
+#include <iostream>
+#include "ast/ast.h"
+#include "util/obj_hashtable.h"
+
+class ast_binary_writer {
+    ast_manager &          m;
+    std::ostream &         m_stream;
+    std::streambuf &       m_out;
+    obj_map<ast, unsigned> m_ids;
+    ast_ref_vector         m_pinned;      // nodes in m_ids are kept alive
+    unsigned_vector        m_family2idx;
+    unsigned               m_num_families;
+    ptr_vector<ast>        m_todo;
+    bool                   m_finished;
+
+    void write_byte(unsigned char b);
+    void write_bytes(char const * s, size_t len);
+    void write_uint(uint64_t n);
+    void write_int(int64_t n);
+    void write_symbol(symbol const & s);
+    void write_ref(ast * n) { write_uint(m_ids[n]); }
+    void write_family(family_id fid);
+    unsigned family_ref(family_id fid) const { return fid == null_family_id ? 0 : m_family2idx[fid] + 1; }
+    void write_parameters(decl * d);
+    void push_children(ast * n);
+    void write_node(ast * n);
+
+public:
+    ast_binary_writer(ast_manager & m, std::ostream & out);
+    ~ast_binary_writer();
+
+    /**
+       \brief write n and the sub-terms that were not written yet.
+    */
+    void write(ast * n);
+
+    /**
+       \brief mark the end of the stream.
+       It is also written when the writer is destroyed.
+       Failed writes set the badbit of the output stream.
+    */
+    void finish();
+};
+
+class ast_binary_reader {
+    ast_manager &          m;
+    std::streambuf &       m_in;
+    ast_ref_vector         m_nodes;
+    svector<family_id>     m_families;
+    bool                   m_done;
+
+    unsigned char read_byte();
+    uint64_t read_uint();
+    unsigned read_unsigned();
+    int read_int();
+    void read_string(std::string & s);
+    symbol read_symbol();
+    ast * read_ref();
+    sort * read_sort_ref();
+    expr * read_expr_ref();
+    family_id read_family();
+    void read_parameters(vector<parameter> & ps);
+    void read_sort();
+    void read_func_decl();
+    void read_app();
+    void read_var();
+    void read_quantifier();
+
+public:
+    /**
+       \brief check the header of the stream.
+       Throws default_exception if it is not a binary AST stream of a supported version.
+    */
+    ast_binary_reader(ast_manager & m, std::istream & in);
+
+    /**
+       \brief return the next root, or nullptr at the end of the stream.
+    */
+    ast * read();
+};
+
+void serialize(ast_manager & m, unsigned num_asts, ast * const * asts, std::ostream & out);
+
+void deserialize(ast_manager & m, std::istream & in, ast_ref_vector & result);
@@ -39,7 +39,8 @@ void ast_translation::cleanup() {
 
 void ast_translation::reset_cache() {
     for (auto & kv : m_cache) {
-        m_from_manager.dec_ref(kv.m_key);
+        if (m_pin_from) 
+            m_from_manager.dec_ref(kv.m_key);
         m_to_manager.dec_ref(kv.m_value);
     }
     m_cache.reset();
@@ -48,7 +49,8 @@ void ast_translation::reset_cache() {
 void ast_translation::cache(ast * s, ast * t) {
     SASSERT(!m_cache.contains(s));
     if (s->get_ref_count() > 1) {
-        m_from_manager.inc_ref(s);
+        if (m_pin_from) 
+            m_from_manager.inc_ref(s);
         m_to_manager.inc_ref(t);
         m_cache.insert(s, t);
         ++m_insert_count;
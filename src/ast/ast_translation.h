@@ -36,6 +36,7 @@ class ast_translation {
     ptr_vector<ast>     m_extra_children_stack; // for sort and func_decl, since they have nested AST in their parameters
     ptr_vector<ast>     m_result_stack; 
     obj_map<ast, ast*>  m_cache;
+    bool                m_pin_from;  // terms in a frozen source manager are not reference counted
     unsigned            m_loop_count;
     unsigned            m_hit_count;
     unsigned            m_miss_count;
@@ -59,6 +60,7 @@ public:
         m_miss_count = 0;
         m_insert_count = 0;
         m_num_process = 0;
+        m_pin_from = !from.is_frozen();
         if (&from != &to) {
             if (copy_plugins)
                 m_to_manager.copy_families_plugins(m_from_manager);
@@ -0,0 +1,115 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    rewrite_memo.cpp
+
+Abstract:
+
+    Bounded memo of rewrite results that persists across rewriter invocations.
+
+--*/
+#include "ast/rewriter/rewrite_memo.h"
+
+rewrite_memo::rewrite_memo(ast_manager & m, unsigned max_size):
+    m(m),
+    m_max_size(max_size) {
+    reset();
+}
+
+rewrite_memo::~rewrite_memo() {
+    reset();
+}
+
+void rewrite_memo::reset() {
+    for (unsigned i = 1; i < m_entries.size(); ++i) {
+        entry & e = m_entries[i];
+        if (e.m_key) {
+            m.dec_ref(e.m_key);
+            m.dec_ref(e.m_value);
+        }
+    }
+    m_entries.reset();
+    m_free.reset();
+    m_table.reset();
+    entry sentinel = { nullptr, 0, nullptr, 0, 0 };
+    m_entries.push_back(sentinel);
+}
+
+void rewrite_memo::unlink(unsigned i) {
+    entry & e = m_entries[i];
+    m_entries[e.m_prev].m_next = e.m_next;
+    m_entries[e.m_next].m_prev = e.m_prev;
+}
+
+void rewrite_memo::push_front(unsigned i) {
+    entry & e = m_entries[i];
+    e.m_prev = 0;
+    e.m_next = m_entries[0].m_next;
+    m_entries[e.m_next].m_prev = i;
+    m_entries[0].m_next = i;
+}
+
+void rewrite_memo::evict() {
+    unsigned i = m_entries[0].m_prev;
+    SASSERT(i != 0);
+    entry & e = m_entries[i];
+    unlink(i);
+    m_table.erase(key(e.m_key, e.m_fp));
+    m.dec_ref(e.m_key);
+    m.dec_ref(e.m_value);
+    e.m_key = nullptr;
+    e.m_value = nullptr;
+    m_free.push_back(i);
+    m_stats.m_evictions++;
+}
+
+expr * rewrite_memo::find(expr * t, unsigned fp) {
+    unsigned i;
+    if (!m_table.find(key(t, fp), i)) {
+        m_stats.m_misses++;
+        return nullptr;
+    }
+    m_stats.m_hits++;
+    unlink(i);
+    push_front(i);
+    return m_entries[i].m_value;
+}
+
+void rewrite_memo::insert(expr * t, unsigned fp, expr * r) {
+    if (m_max_size == 0 || m_table.contains(key(t, fp)))
+        return;
+    while (m_table.size() >= m_max_size)
+        evict();
+    m.inc_ref(t);
+    m.inc_ref(r);
+    unsigned i;
+    if (m_free.empty()) {
+        i = m_entries.size();
+        m_entries.push_back(entry());
+    }
+    else {
+        i = m_free.back();
+        m_free.pop_back();
+    }
+    entry & e = m_entries[i];
+    e.m_key = t;
+    e.m_fp = fp;
+    e.m_value = r;
+    push_front(i);
+    m_table.insert(key(t, fp), i);
+}
+
+void rewrite_memo::set_max_size(unsigned max_size) {
+    m_max_size = max_size;
+    while (m_table.size() > m_max_size)
+        evict();
+}
+
+void rewrite_memo::collect_statistics(statistics & st) const {
+    st.update("rewrite memo hits", m_stats.m_hits);
+    st.update("rewrite memo misses", m_stats.m_misses);
+    st.update("rewrite memo evictions", m_stats.m_evictions);
+    st.update("rewrite memo size", size());
+}
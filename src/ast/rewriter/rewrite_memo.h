@@ -0,0 +1,77 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    rewrite_memo.h
+
+Abstract:
+
+    Bounded memo of rewrite results that persists across rewriter invocations.
+
+    Results are keyed by the rewritten expression and a fingerprint of the
+    parameters of the rewriter that produced them. The memo holds references
+    to keys and results. When it exceeds its maximal size, the least
+    recently used entries are evicted.
+
+--*/
+#pragma once
+
+#include "ast/ast.h"
+#include "util/map.h"
+#include "util/statistics.h"
+
+class rewrite_memo {
+    typedef std::pair<expr*, unsigned> key;
+    struct key_hash {
+        unsigned operator()(key const & k) const { return combine_hash(k.first->hash(), k.second); }
+    };
+    struct entry {
+        expr *   m_key;
+        unsigned m_fp;
+        expr *   m_value;
+        unsigned m_prev;
+        unsigned m_next;
+    };
+    struct stats {
+        unsigned m_hits;
+        unsigned m_misses;
+        unsigned m_evictions;
+        stats() { reset(); }
+        void reset() { memset(this, 0, sizeof(*this)); }
+    };
+
+    ast_manager &   m;
+    // entry 0 is the sentinel of the recency list, m_entries[0].m_next is the most recently used entry.
+    svector<entry>  m_entries;
+    unsigned_vector m_free;
+    map<key, unsigned, key_hash, default_eq<key>> m_table;
+    unsigned        m_max_size;
+    stats           m_stats;
+
+    void unlink(unsigned i);
+    void push_front(unsigned i);
+    void evict();
+
+public:
+    rewrite_memo(ast_manager & m, unsigned max_size);
+    ~rewrite_memo();
+
+    /**
+       \brief return the result memoized for t under fingerprint fp, or nullptr.
+       A hit makes the entry the most recently used one.
+    */
+    expr * find(expr * t, unsigned fp);
+
+    bool contains(expr * t, unsigned fp) const { return m_table.contains(key(t, fp)); }
+
+    void insert(expr * t, unsigned fp, expr * r);
+
+    void set_max_size(unsigned max_size);
+    unsigned max_size() const { return m_max_size; }
+    unsigned size() const { return m_table.size(); }
+    void reset();
+
+    void collect_statistics(statistics & st) const;
+    void reset_statistics() { m_stats.reset(); }
+};
@@ -29,12 +29,15 @@ Notes:
 #include "ast/rewriter/recfun_rewriter.h"
 #include "ast/rewriter/seq_rewriter.h"
 #include "ast/rewriter/rewriter_def.h"
+#include "ast/rewriter/rewrite_memo.h"
 #include "ast/rewriter/var_subst.h"
 #include "ast/expr_substitution.h"
 #include "ast/ast_smt2_pp.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_util.h"
 #include "ast/well_sorted.h"
+#include "util/gparams.h"
+#include <sstream>
 
 namespace {
 struct th_rewriter_cfg : public default_rewriter_cfg {
@@ -64,6 +67,13 @@ struct th_rewriter_cfg : public default_rewriter_cfg {
     expr_dependency_ref m_used_dependencies; // set of dependencies of used substitutions
     expr_substitution * m_subst;
 
+    // memo of results that persists across invocations
+    unsigned            m_memo_size;
+    unsigned            m_memo_fp;       // fingerprint of the parameters
+    scoped_ptr<rewrite_memo> m_own_memo;
+    rewrite_memo *      m_ext_memo;
+    rewrite_memo *      m_memo;          // memo in use, nullptr if disabled
+
     ast_manager & m() const { return m_b_rw.m(); }
 
     void updt_local_params(params_ref const & _p) {
@@ -77,6 +87,35 @@ struct th_rewriter_cfg : public default_rewriter_cfg {
         m_push_ite_bv    = p.push_ite_bv();
         m_ignore_patterns_on_ground_qbody = p.ignore_patterns_on_ground_qbody();
         m_rewrite_patterns = p.rewrite_patterns();
+        m_memo_size      = p.memo_size();
+        if (m_memo_size > 0) {
+            std::ostringstream strm;
+            _p.display(strm);
+            gparams::get_module("rewriter").display(strm);
+            std::string fp = strm.str();
+            m_memo_fp = string_hash(fp.c_str(), static_cast<unsigned>(fp.size()), 17);
+        }
+        init_memo();
+    }
+
+    void init_memo() {
+        m_memo = nullptr;
+        if (m_memo_size == 0 || m().proofs_enabled())
+            return;
+        if (!m_ext_memo && !m_own_memo)
+            m_own_memo = alloc(rewrite_memo, m(), m_memo_size);
+        m_memo = m_ext_memo ? m_ext_memo : m_own_memo.get();
+        m_memo->set_max_size(m_memo_size);
+    }
+
+    void set_memo(rewrite_memo * memo) {
+        m_ext_memo = memo;
+        init_memo();
+    }
+
+    // results are memoized for ground applications, whose rewriting does not depend on bound variables.
+    static bool is_memo_key(expr * e) {
+        return is_app(e) && to_app(e)->get_num_args() > 0 && to_app(e)->is_ground();
     }
 
     void updt_params(params_ref const & p) {
@@ -761,7 +800,11 @@ struct th_rewriter_cfg : public default_rewriter_cfg {
         m_a_util(m),
         m_bv_util(m),
         m_used_dependencies(m),
-        m_subst(nullptr) {
+        m_subst(nullptr),
+        m_memo_size(0),
+        m_memo_fp(0),
+        m_ext_memo(nullptr),
+        m_memo(nullptr) {
         updt_local_params(p);
     }
 
@@ -775,8 +818,12 @@ struct th_rewriter_cfg : public default_rewriter_cfg {
     }
 
     bool get_subst(expr * s, expr * & t, proof * & pr) {
-        if (m_subst == nullptr)
-            return false;
+        if (m_subst == nullptr) {
+            if (!m_memo || !is_memo_key(s))
+                return false;
+            t = m_memo->find(s, m_memo_fp);
+            return t != nullptr;
+        }
         expr_dependency * d = nullptr;
         if (m_subst->find(s, t, pr, d)) {
             m_used_dependencies = m().mk_join(m_used_dependencies, d);
@@ -804,6 +851,37 @@ struct th_rewriter::imp : public rewriter_tpl<th_rewriter_cfg> {
     void set_solver(expr_solver* solver) {
         m_cfg.m_seq_rw.set_solver(solver);
     }
+
+    /**
+       \brief memoize the result r of rewriting t, and the results of
+       shared subterms of t that were cached by the last invocation.
+    */
+    void memoize(expr * t, expr * r) {
+        rewrite_memo * memo = m_cfg.m_memo;
+        if (!memo || m_cfg.m_subst || !th_rewriter_cfg::is_memo_key(t))
+            return;
+        unsigned fp = m_cfg.m_memo_fp;
+        bool known = memo->contains(t, fp);
+        memo->insert(t, fp, r);
+        if (known)
+            return;
+        ptr_buffer<expr> todo;
+        expr_mark visited;
+        todo.append(to_app(t)->get_num_args(), to_app(t)->get_args());
+        while (!todo.empty()) {
+            expr * e = todo.back();
+            todo.pop_back();
+            if (visited.is_marked(e) || !th_rewriter_cfg::is_memo_key(e))
+                continue;
+            visited.mark(e);
+            expr * v = get_cached(e);
+            if (v)
+                memo->insert(e, fp, v);
+            else if (memo->contains(e, fp))
+                continue; // found in the memo, its subterms were not visited
+            todo.append(to_app(e)->get_num_args(), to_app(e)->get_args());
+        }
+    }
 };
 
 th_rewriter::th_rewriter(ast_manager & m, params_ref const & p):
@@ -843,8 +921,11 @@ unsigned th_rewriter::get_num_steps() const {
 
 void th_rewriter::cleanup() {
     ast_manager & m = m_imp->m();
+    rewrite_memo * memo = m_imp->cfg().m_ext_memo;
     m_imp->~imp();
     new (m_imp) imp(m, m_params);
+    if (memo)
+        set_memo(memo);
 }
 
 void th_rewriter::reset() {
@@ -855,15 +936,18 @@ void th_rewriter::reset() {
 void th_rewriter::operator()(expr_ref & term) {
     expr_ref result(term.get_manager());
     m_imp->operator()(term, result);
+    m_imp->memoize(term, result);
     term = std::move(result);
 }
 
 void th_rewriter::operator()(expr * t, expr_ref & result) {
     m_imp->operator()(t, result);
+    m_imp->memoize(t, result);
 }
 
 void th_rewriter::operator()(expr * t, expr_ref & result, proof_ref & result_pr) {
     m_imp->operator()(t, result, result_pr);
+    m_imp->memoize(t, result);
 }
 
 expr_ref th_rewriter::operator()(expr * n, unsigned num_bindings, expr * const * bindings) {
@@ -894,6 +978,15 @@ void th_rewriter::set_solver(expr_solver* solver) {
     m_imp->set_solver(solver);
 }
 
+void th_rewriter::set_memo(rewrite_memo * memo) {
+    m_imp->cfg().set_memo(memo);
+}
+
+void th_rewriter::collect_statistics(statistics & st) const {
+    if (m_imp->cfg().m_memo)
+        m_imp->cfg().m_memo->collect_statistics(st);
+}
+
 
 bool th_rewriter::reduce_quantifier(quantifier * old_q, 
                                     expr * new_body, 
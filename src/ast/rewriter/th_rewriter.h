@@ -21,11 +21,14 @@ Notes:
 #include "ast/ast.h"
 #include "ast/rewriter/rewriter_types.h"
 #include "util/params.h"
+#include "util/statistics.h"
 
 class expr_substitution;
 
 class expr_solver;
 
+class rewrite_memo;
+
 class th_rewriter {
     struct     imp;
     imp *      m_imp;
@@ -69,5 +72,13 @@ public:
 
     void set_solver(expr_solver* solver);
 
+    /**
+       \brief use memo, instead of a memo owned by the rewriter, when memo_size is positive.
+       The memo can be shared by rewriters over the same manager, and outlive them.
+    */
+    void set_memo(rewrite_memo * memo);
+
+    void collect_statistics(statistics & st) const;
+
 };
 
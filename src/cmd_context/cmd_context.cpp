@@ -491,7 +491,8 @@ cmd_context::cmd_context(bool main_ctx, ast_manager * m, symbol const & l):
     m_pmanager(nullptr),
     m_sexpr_manager(nullptr),
     m_regular("stdout", std::cout),
-    m_diagnostic("stderr", std::cerr) {
+    m_diagnostic("stderr", std::cerr),
+    m_release_lim(1024*1024) {
     SASSERT(m != 0 || !has_manager());
     install_basic_cmds(*this);
     install_ext_basic_cmds(*this);
@@ -1494,7 +1495,13 @@ void cmd_context::pop(unsigned n) {
     while (n--) {
         m().limit().pop();
     }
-
+    // popped terms leave entire chunks free in long running sessions.
+    // They are released when the free memory doubled since the last release.
+    small_object_allocator & a = m().get_allocator();
+    if (a.get_wasted_size() >= m_release_lim) {
+        a.release_free_chunks();
+        m_release_lim = std::max(static_cast<size_t>(1024*1024), 2 * a.get_wasted_size());
+    }
 }
 
 void cmd_context::check_sat(unsigned num_assumptions, expr * const * assumptions) {
@@ -1502,6 +1509,8 @@ void cmd_context::check_sat(unsigned num_assumptions, expr * const * assumptions
         return;
     IF_VERBOSE(100, verbose_stream() << "(started \"check-sat\")" << std::endl;);
     init_manager();
+    // search dominates the latency of check-sat, so it is a safe point for deferred deletions.
+    m().drain();
     TRACE("before_check_sat", dump_assertions(tout););
     unsigned timeout = m_params.m_timeout;
     unsigned rlimit  = m_params.rlimit();
@@ -2006,6 +2015,7 @@ void cmd_context::display_statistics(bool show_total_time, double total_time) {
     st.update("time", get_seconds());
     get_memory_statistics(st);
     get_rlimit_statistics(m().limit(), st);
+    m().collect_statistics(st);
     if (m_check_sat_result) {
         m_check_sat_result->collect_statistics(st);
     }
@@ -238,6 +238,7 @@ protected:
     };
 
     svector<scope>               m_scopes;
+    size_t                       m_release_lim; // wasted allocator memory at which pop releases free chunks
     scoped_ptr<solver_factory>   m_solver_factory;
     ref<solver>                  m_solver;
     ref<check_sat_result>        m_check_sat_result;
@@ -34,6 +34,8 @@ public:
     std::string m_dot_proof_file;
     bool        m_interpolants;
     bool        m_debug_ref_count;
+    unsigned    m_del_budget;
+    bool        m_huge_pages;
     bool        m_trace;
     std::string m_trace_file_name;
     bool        m_well_sorted_check;
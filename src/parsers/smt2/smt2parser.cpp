@@ -17,6 +17,7 @@ Revision History:
 
 --*/
 #include "util/stack.h"
+#include "util/mapped_file.h"
 #include "ast/datatype_decl_plugin.h"
 #include "ast/bv_decl_plugin.h"
 #include "ast/arith_decl_plugin.h"
@@ -3002,10 +3003,15 @@ namespace smt2 {
         }
 
     public:
-        parser(cmd_context & ctx, std::istream & is, bool interactive, params_ref const & p, char const * filename=nullptr):
+        /**
+           \brief the input arguments are passed to the scanner:
+           either an input stream and an interactive flag, or a range of characters.
+        */
+        template<typename... Input>
+        parser(cmd_context & ctx, params_ref const & p, char const * filename, Input &&... in):
             m_ctx(ctx),
             m_params(p),
-            m_scanner(ctx, is, interactive),
+            m_scanner(ctx, std::forward<Input>(in)...),
             m_curr(scanner::NULL_TOKEN),
             m_curr_cmd(nullptr),
             m_num_bindings(0),
@@ -3175,12 +3181,25 @@ namespace smt2 {
 };
 
 bool parse_smt2_commands(cmd_context & ctx, std::istream & is, bool interactive, params_ref const & ps, char const * filename) {
-    smt2::parser p(ctx, is, interactive, ps, filename);
+    smt2::parser p(ctx, ps, filename, is, interactive);
+    return p();
+}
+
+bool parse_smt2_commands(cmd_context & ctx, char const * begin, char const * end, params_ref const & ps, char const * filename) {
+    smt2::parser p(ctx, ps, filename, begin, end);
     return p();
 }
 
+bool parse_smt2_commands_from_file(cmd_context & ctx, char const * file_name, bool & opened, params_ref const & ps) {
+    mapped_file f;
+    opened = f.open(file_name);
+    if (!opened)
+        return false;
+    return parse_smt2_commands(ctx, f.begin(), f.end(), ps, file_name);
+}
+
 sexpr_ref parse_sexpr(cmd_context& ctx, std::istream& is, params_ref const& ps, char const* filename) {
-    smt2::parser p(ctx, is, false, ps, filename);
+    smt2::parser p(ctx, ps, filename, is, false);
     return p.parse_sexpr_ref();
     
 }
@@ -22,5 +22,16 @@ Revision History:
 
 bool parse_smt2_commands(cmd_context & ctx, std::istream & is, bool interactive = false, params_ref const & p = params_ref(), char const * filename = nullptr);
 
+/**
+   \brief parse the commands in the characters [begin, end), which are scanned in place.
+*/
+bool parse_smt2_commands(cmd_context & ctx, char const * begin, char const * end, params_ref const & p = params_ref(), char const * filename = nullptr);
+
+/**
+   \brief parse the commands in the given file, which is memory mapped when possible.
+   opened is set to false if the file cannot be read.
+*/
+bool parse_smt2_commands_from_file(cmd_context & ctx, char const * file_name, bool & opened, params_ref const & p = params_ref());
+
 sexpr_ref parse_sexpr(cmd_context& ctx, std::istream& is, params_ref const& ps, char const* filename);
 
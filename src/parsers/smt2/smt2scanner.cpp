@@ -21,35 +21,55 @@ Revision History:
 
 namespace smt2 {
 
-    void scanner::next() {
+    void scanner::next_core() {
         if (m_cache_input)
             m_cache.push_back(m_curr);
         if (m_at_eof)
             throw scanner_exception("unexpected end of file");
-        if (m_interactive) {
-            m_curr = m_stream.get();
-            if (m_stream.eof())
-                m_at_eof = true;
-        }
-        else if (m_bpos < m_bend) {
-            m_curr = m_buffer[m_bpos];
+        if (m_bpos < m_bend) {
+            m_curr = *m_bpos;
             m_bpos++;
         }
+        else if (!m_stream) {
+            m_at_eof = true;
+        }
+        else if (m_interactive) {
+            m_curr = m_stream->get();
+            if (m_stream->eof())
+                m_at_eof = true;
+        }
         else {
-            m_stream.read(m_buffer, SCANNER_BUFFER_SIZE);
-            m_bend = static_cast<unsigned>(m_stream.gcount());
-            m_bpos = 0;
+            m_stream->read(m_buffer.c_ptr(), SCANNER_BUFFER_SIZE);
+            m_bpos = m_buffer.c_ptr();
+            m_bend = m_bpos + m_stream->gcount();
             if (m_bpos == m_bend) {
                 m_at_eof = true;
             }
             else {
-                m_curr = m_buffer[m_bpos];
+                m_curr = *m_bpos;
                 m_bpos++;
             }
         }
         m_spos++;
     }
 
+    /**
+       \brief consume the current character and the buffered characters in [m_bpos, e).
+    */
+    void scanner::skip_run(char const * e) {
+        SASSERT(m_bpos <= e && e <= m_bend);
+        if (m_bpos != e) {
+            if (m_cache_input) {
+                m_cache.push_back(m_curr);
+                m_cache.append(static_cast<unsigned>(e - m_bpos - 1), m_bpos);
+            }
+            m_spos += static_cast<int>(e - m_bpos);
+            m_curr = e[-1];
+            m_bpos = e;
+        }
+        next();
+    }
+
     void scanner::read_comment() {
         SASSERT(curr() == ';');
         next();
@@ -62,7 +82,10 @@ namespace smt2 {
                 next();
                 return;
             }
-            next();
+            char const * e = m_bpos;
+            while (e < m_bend && *e != '\n')
+                ++e;
+            skip_run(e);
         }
     }
     
@@ -115,10 +138,14 @@ namespace smt2 {
     scanner::token scanner::read_symbol_core() {
         while (!m_at_eof) {
             char c = curr();
-            signed char n = m_normalized[static_cast<unsigned char>(c)];
-            if (n == 'a' || n == '0' || n == '-') {
+            if (is_symbol_char(c)) {
+                // take the run of symbol characters that is already buffered at once.
+                char const * e = m_bpos;
+                while (e < m_bend && is_symbol_char(*e))
+                    ++e;
                 m_string.push_back(c);
-                next();
+                m_string.append(static_cast<unsigned>(e - m_bpos), m_bpos);
+                skip_run(e);
             }
             else {
                 m_string.push_back(0);
@@ -145,31 +172,57 @@ namespace smt2 {
 
     scanner::token scanner::read_number() {
         SASSERT('0' <= curr() && curr() <= '9');
-        rational q(1);
-        m_number = rational(curr() - '0');
-        next();
         bool is_float = false;
-
+        m_string.reset();
         while (!m_at_eof) {
             char c = curr();
             if ('0' <= c && c <= '9') {
-                m_number = rational(10)*m_number + rational(c - '0');
-                if (is_float)
-                    q *= rational(10);
-                next();
+                char const * e = m_bpos;
+                while (e < m_bend && '0' <= *e && *e <= '9')
+                    ++e;
+                m_string.push_back(c);
+                m_string.append(static_cast<unsigned>(e - m_bpos), m_bpos);
+                skip_run(e);
             }
             else if (c == '.') {
                 if (is_float)
                     break;
                 is_float = true;
+                m_string.push_back(c);
                 next();
             }
             else {
                 break;
             }
         }
-        if (is_float)
-            m_number /= q;
+        // numerals of up to 19 digits are accumulated in machine integers.
+        bool small = m_string.size() <= (is_float ? 20u : 19u);
+        uint64_t n = 0, q = 1;
+        rational big_n(0), big_q(1);
+        bool in_frac = false;
+        for (char c : m_string) {
+            if (c == '.') {
+                in_frac = true;
+            }
+            else if (small) {
+                n = 10*n + (c - '0');
+                if (in_frac)
+                    q *= 10;
+            }
+            else {
+                big_n = rational(10)*big_n + rational(c - '0');
+                if (in_frac)
+                    big_q *= rational(10);
+            }
+        }
+        if (small) {
+            m_number = rational(n, rational::ui64());
+            if (q != 1)
+                m_number /= rational(q, rational::ui64());
+        }
+        else {
+            m_number = big_n / big_q;
+        }
         TRACE("scanner", tout << "new number: " << m_number << "\n";);
         return is_float ? FLOAT_TOKEN : INT_TOKEN;
     }
@@ -279,12 +332,32 @@ namespace smt2 {
         m_line(1),
         m_pos(0),
         m_bv_size(UINT_MAX),
-        m_bpos(0),
-        m_bend(0),
-        m_stream(stream),
+        m_bpos(nullptr),
+        m_bend(nullptr),
+        m_stream(&stream),
         m_cache_input(false) {
+        if (!interactive)
+            m_buffer.resize(SCANNER_BUFFER_SIZE);
+        init();
+    }
 
+    scanner::scanner(cmd_context & ctx, char const * begin, char const * end) :
+        ctx(ctx),
+        m_interactive(false),
+        m_spos(0),
+        m_curr(0),
+        m_at_eof(false),
+        m_line(1),
+        m_pos(0),
+        m_bv_size(UINT_MAX),
+        m_bpos(begin),
+        m_bend(end),
+        m_stream(nullptr),
+        m_cache_input(false) {
+        init();
+    }
 
+    void scanner::init() {
         for (int i = 0; i < 256; ++i) {
             m_normalized[i] = (signed char) i;
         }
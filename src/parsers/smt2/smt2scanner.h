@@ -44,12 +44,15 @@ namespace smt2 {
         unsigned           m_bv_size;
         // end of data
         signed char        m_normalized[256];
-#define SCANNER_BUFFER_SIZE 1024
-        char               m_buffer[SCANNER_BUFFER_SIZE];
-        unsigned           m_bpos;
-        unsigned           m_bend;
+#define SCANNER_BUFFER_SIZE (1 << 16)
+        // characters not yet scanned are in [m_bpos, m_bend).
+        // They point into m_buffer when reading from a stream,
+        // and into the caller's memory otherwise.
+        svector<char>      m_buffer;
+        char const *       m_bpos;
+        char const *       m_bend;
         svector<char>      m_string;
-        std::istream&      m_stream;
+        std::istream*      m_stream;
         
         bool               m_cache_input;
         svector<char>      m_cache;
@@ -58,7 +61,21 @@ namespace smt2 {
         
         char curr() const { return m_curr; }
         void new_line() { m_line++; m_spos = 0; }
-        void next();
+        void next() {
+            if (!m_cache_input && m_bpos < m_bend) {
+                m_curr = *m_bpos++;
+                m_spos++;
+            }
+            else
+                next_core();
+        }
+        void next_core();
+        void skip_run(char const * e);
+        bool is_symbol_char(char c) const {
+            signed char n = m_normalized[static_cast<unsigned char>(c)];
+            return n == 'a' || n == '0' || n == '-';
+        }
+        void init();
         
     public:
         
@@ -76,6 +93,12 @@ namespace smt2 {
         };
         
         scanner(cmd_context & ctx, std::istream& stream, bool interactive = false);
+
+        /**
+           \brief scan the characters in [begin, end) in place.
+           The memory must remain valid while the scanner is used.
+        */
+        scanner(cmd_context & ctx, char const * begin, char const * end);
         
         ~scanner() {}    
         
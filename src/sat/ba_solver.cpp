@@ -1240,8 +1240,16 @@ namespace sat {
                 break;
             }
             case justification::EXT_JUSTIFICATION: {
-                constraint& cnstr = index2constraint(js.get_ext_justification_idx());
                 ++m_stats.m_num_resolves;
+                if (xor_gauss::is_gauss(js.get_ext_justification_idx())) {
+                    m_lemma.reset();
+                    inc_bound(offset);
+                    inc_coeff(consequent, offset);
+                    m_gauss.get_antecedents(consequent, js.get_ext_justification_idx(), m_lemma);
+                    for (literal l : m_lemma) process_antecedent(~l, offset);
+                    break;
+                }
+                constraint& cnstr = index2constraint(js.get_ext_justification_idx());
                 switch (cnstr.tag()) {
                 case card_t: {
                     card& c = cnstr.to_card();
@@ -1572,34 +1580,41 @@ namespace sat {
             case justification::EXT_JUSTIFICATION: {
                 ++m_stats.m_num_resolves;
                 ext_justification_idx index = js.get_ext_justification_idx();
-                constraint& cnstr = index2constraint(index);
-                SASSERT(!cnstr.was_removed());
-                switch (cnstr.tag()) {
-                case card_t: 
-                case pb_t: {
-                    pb_base const& p = cnstr.to_pb_base();
-                    unsigned k = p.k(), sz = p.size();
-                    m_A.reset(0);
-                    for (unsigned i = 0; i < sz; ++i) {
-                        literal l = p.get_lit(i);
-                        unsigned c = p.get_coeff(i);
-                        if (l == consequent || !is_visited(l.var())) {
-                            m_A.push(l, c);
-                        }
-                        else {
-                            SASSERT(k > c);
-                            TRACE("ba", tout << "visited: " << l << "\n";);
-                            k -= c;
+                bool is_pb = false;
+                if (xor_gauss::is_gauss(index)) {
+                    gauss2pb(consequent, index, 1, m_A);
+                }
+                else {
+                    constraint& cnstr = index2constraint(index);
+                    SASSERT(!cnstr.was_removed());
+                    is_pb = cnstr.is_pb();
+                    switch (cnstr.tag()) {
+                    case card_t: 
+                    case pb_t: {
+                        pb_base const& p = cnstr.to_pb_base();
+                        unsigned k = p.k(), sz = p.size();
+                        m_A.reset(0);
+                        for (unsigned i = 0; i < sz; ++i) {
+                            literal l = p.get_lit(i);
+                            unsigned c = p.get_coeff(i);
+                            if (l == consequent || !is_visited(l.var())) {
+                                m_A.push(l, c);
+                            }
+                            else {
+                                SASSERT(k > c);
+                                TRACE("ba", tout << "visited: " << l << "\n";);
+                                k -= c;
+                            }
                         }
+                        SASSERT(k > 0);
+                        if (p.lit() != null_literal) m_A.push(~p.lit(), k);
+                        m_A.m_k = k;
+                        break;                 
+                    }
+                    default:
+                        constraint2pb(cnstr, consequent, 1, m_A);
+                        break;
                     }
-                    SASSERT(k > 0);
-                    if (p.lit() != null_literal) m_A.push(~p.lit(), k);
-                    m_A.m_k = k;
-                    break;                 
-                }
-                default:
-                    constraint2pb(cnstr, consequent, 1, m_A);
-                    break;
                 }
                 mark_variables(m_A);
                 if (consequent == null_literal) {
@@ -1611,7 +1626,7 @@ namespace sat {
                 }
                 else {
                     round_to_one(consequent.var());
-                    if (cnstr.is_pb()) round_to_one(m_A, consequent.var()); 
+                    if (is_pb) round_to_one(m_A, consequent.var()); 
                     SASSERT(validate_ineq(m_A)); 
                     resolve_with(m_A);
                 }
@@ -1867,18 +1882,19 @@ namespace sat {
 
     ba_solver::ba_solver()
         : m_solver(nullptr), m_lookahead(nullptr), 
-          m_constraint_id(0), m_ba(*this), m_sort(m_ba) {
+          m_ba(*this), m_sort(m_ba) {
         TRACE("ba", tout << this << "\n";);
         m_num_propagations_since_pop = 0;
+        m_gauss_stale = true;
     }
 
     ba_solver::~ba_solver() {
         m_stats.reset();
         for (constraint* c : m_constraints) {
-            m_allocator.deallocate(c->obj_size(), c);
+            del_constraint(*c);
         }
         for (constraint* c : m_learned) {
-            m_allocator.deallocate(c->obj_size(), c);
+            del_constraint(*c);
         }
     }
 
@@ -1905,6 +1921,7 @@ namespace sat {
 
     void ba_solver::add_constraint(constraint* c) {
         literal_vector lits(c->literals());
+        m_id2constraint.setx(c->id(), c, nullptr);
         if (c->learned()) {
             m_learned.push_back(c);
         }
@@ -2011,7 +2028,7 @@ namespace sat {
             parity1 ^= l.sign();
         }
         for (auto const & w : get_wlist(lits[0])) {
-            if (w.get_kind() != watched::EXT_CONSTRAINT) continue;
+            if (w.get_kind() != watched::EXT_CONSTRAINT || xor_gauss::is_gauss(w.get_ext_constraint_idx())) continue;
             constraint& c = index2constraint(w.get_ext_constraint_idx());
             if (!c.is_xr()) continue;
             xr& x = c.to_xr();
@@ -2093,6 +2110,8 @@ namespace sat {
     */
     bool ba_solver::propagate(literal l, ext_constraint_idx idx) {
         SASSERT(value(l) == l_true);
+        if (xor_gauss::is_gauss(idx))
+            return m_gauss.propagate(l);
         constraint& c = index2constraint(idx);
         if (c.lit() != null_literal && l.var() == c.lit().var()) {
             init_watch(c);
@@ -2147,7 +2166,7 @@ namespace sat {
         return pow(0.5, (slack - k + 1)/avg) * to_add;
     }
 
-    double ba_solver::get_reward(literal l, ext_justification_idx idx, literal_occs_fun& occs) const {
+    double ba_solver::get_reward(literal l, ext_constraint_idx idx, literal_occs_fun& occs) const {
         constraint const& c = index2constraint(idx);
         switch (c.tag()) {
         case card_t: return get_reward(c.to_card(), occs);
@@ -2197,7 +2216,10 @@ namespace sat {
         unsigned num_marks = 0;
         while (true) {
             TRACE("ba", tout << "process: " << l << " " << js << "\n";);
-            if (js.get_kind() == justification::EXT_JUSTIFICATION) {
+            if (js.get_kind() == justification::EXT_JUSTIFICATION && xor_gauss::is_gauss(js.get_ext_justification_idx())) {
+                r.push_back(l);
+            }
+            else if (js.get_kind() == justification::EXT_JUSTIFICATION) {
                 constraint& c = index2constraint(js.get_ext_justification_idx());
                 TRACE("ba", tout << c << "\n";);
                 if (!c.is_xr()) {
@@ -2382,6 +2404,8 @@ namespace sat {
     }
 
     bool ba_solver::is_extended_binary(ext_justification_idx idx, literal_vector & r) {
+        if (xor_gauss::is_gauss(idx))
+            return false;
         constraint const& c = index2constraint(idx);
         switch (c.tag()) {
         case card_t: {
@@ -2454,7 +2478,10 @@ namespace sat {
     // constraint generic methods
 
     void ba_solver::get_antecedents(literal l, ext_justification_idx idx, literal_vector & r) {
-        get_antecedents(l, index2constraint(idx), r);
+        if (xor_gauss::is_gauss(idx))
+            m_gauss.get_antecedents(l, idx, r);
+        else
+            get_antecedents(l, index2constraint(idx), r);
     }
 
     bool ba_solver::is_watched(literal lit, constraint const& c) const {
@@ -2507,6 +2534,12 @@ namespace sat {
         }
     }
 
+    void ba_solver::del_constraint(constraint& c) {
+        m_id2constraint[c.id()] = nullptr;
+        m_constraint_id.recycle(c.id());
+        m_allocator.deallocate(c.obj_size(), &c);
+    }
+
     void ba_solver::remove_constraint(constraint& c, char const* reason) {
         TRACE("ba", display(tout << "remove ", c, true) << " " << reason << "\n";);
         IF_VERBOSE(21, display(verbose_stream() << "remove " << reason << " ", c, true););
@@ -2671,7 +2704,7 @@ namespace sat {
     bool ba_solver::validate_watch_literal(literal lit) const {
         if (lvl(lit) == 0) return true;
         for (auto const & w : get_wlist(lit)) {
-            if (w.get_kind() == watched::EXT_CONSTRAINT) {
+            if (w.get_kind() == watched::EXT_CONSTRAINT && !xor_gauss::is_gauss(w.get_ext_constraint_idx())) {
                 constraint const& c = index2constraint(w.get_ext_constraint_idx());
                 if (!c.is_watching(~lit) && lit.var() != c.lit().var()) {
                     IF_VERBOSE(0, display(verbose_stream() << lit << " " << lvl(lit) << " is not watched in " << c << "\n", c, true););
@@ -2800,7 +2833,7 @@ namespace sat {
             constraint* c = m_learned[i];
             if (!m_constraint_to_reinit.contains(c)) {
                 remove_constraint(*c, "gc");
-                m_allocator.deallocate(c->obj_size(), c);
+                del_constraint(*c);
                 ++removed;
             }
             else {
@@ -2901,6 +2934,7 @@ namespace sat {
 
     void ba_solver::push() {
         m_constraint_to_reinit_lim.push_back(m_constraint_to_reinit.size());
+        m_gauss.push();
     }
 
     void ba_solver::pop(unsigned n) {        
@@ -2909,6 +2943,7 @@ namespace sat {
         m_constraint_to_reinit_last_sz = m_constraint_to_reinit_lim[new_lim];
         m_constraint_to_reinit_lim.shrink(new_lim);
         m_num_propagations_since_pop = 0;
+        m_gauss.pop(n);
     }
 
     void ba_solver::pop_reinit() {
@@ -2920,6 +2955,8 @@ namespace sat {
             }
         }
         m_constraint_to_reinit.shrink(sz);        
+        if (m_gauss_stale && s().at_base_lvl() && !inconsistent()) 
+            init_gauss();
     }
 
     
@@ -2942,6 +2979,7 @@ namespace sat {
 
     void ba_solver::pre_simplify() {
         VERIFY(s().at_base_lvl());
+        reset_gauss();
         if (s().inconsistent())
             return;
         m_constraint_removed = false;
@@ -3022,6 +3060,8 @@ namespace sat {
                    if (m_stats.m_num_gc > 0) verbose_stream() << " :gc " << m_stats.m_num_gc;
                    verbose_stream() << ")\n";);
 
+        init_gauss();
+
         // IF_VERBOSE(0, s().display(verbose_stream()));
         // mutex_reduction();
         // if (s().m_clauses.size() < 80000) lp_lookahead_reduction();
@@ -3188,6 +3228,7 @@ namespace sat {
 
     void ba_solver::flush_roots() {
         if (m_roots.empty()) return;
+        reset_gauss();
         reserve_roots();
         // validate();
         m_constraint_removed = false;
@@ -3835,6 +3876,43 @@ namespace sat {
         }
     }
 
+    void ba_solver::reset_gauss() {
+        m_gauss.reset();
+        m_gauss_stale = true;
+    }
+
+    /**
+       \brief rebuild the Gauss-Jordan matrix from the current xr constraints.
+       The matrix is built at base level, and it is not available for lookahead
+       or DRAT, since its propagations are not justified by individual constraints.
+     */
+    void ba_solver::init_gauss() {
+        m_gauss.reset();
+        m_gauss_stale = false;
+        if (!m_solver || m_lookahead || !get_config().m_xor_gauss || get_config().m_drat || 
+            !s().at_base_lvl() || s().inconsistent())
+            return;
+        for (constraint* c : m_constraints)
+            if (c->is_xr() && !c->was_removed())
+                m_gauss.add_xor(c->literals());
+        for (constraint* c : m_learned)
+            if (c->is_xr() && !c->was_removed())
+                m_gauss.add_xor(c->literals());
+        m_gauss.init(s(), get_config().m_xor_gauss_max_vars);
+    }
+
+    /**
+       \brief the propagation of lit by a row corresponds to the clause
+       lit or ~a1 or .. or ~an, where a1, .., an are the antecedents.
+     */
+    void ba_solver::gauss2pb(literal lit, ext_justification_idx idx, unsigned offset, ineq& ineq) {
+        literal_vector lits;
+        m_gauss.get_antecedents(lit, idx, lits);
+        ineq.reset(offset);
+        if (lit != null_literal) ineq.push(lit, offset);
+        for (literal l : lits) ineq.push(~l, offset);
+    }
+
     void ba_solver::extract_xor() {
         xor_finder xf(s());
         std::function<void (literal_vector const&)> f = [this](literal_vector const& l) { add_xr(l, false); };
@@ -3900,7 +3978,7 @@ namespace sat {
             if (c.was_removed()) {
                 clear_watch(c);
                 nullify_tracking_literal(c);
-                m_allocator.deallocate(c.obj_size(), &c);
+                del_constraint(c);
             }
             else if (learned && !c.learned()) {
                 m_constraints.push_back(&c);
@@ -4447,10 +4525,14 @@ namespace sat {
     }
 
     std::ostream& ba_solver::display_justification(std::ostream& out, ext_justification_idx idx) const {
+        if (xor_gauss::is_gauss(idx))
+            return m_gauss.display_justification(out, idx);
         return out << index2constraint(idx);
     }
 
     std::ostream& ba_solver::display_constraint(std::ostream& out, ext_constraint_idx idx) const {
+        if (xor_gauss::is_gauss(idx))
+            return out << "gauss";
         return out << index2constraint(idx);
     }
 
@@ -4474,6 +4556,7 @@ namespace sat {
         st.update("ba big strengthenings", m_stats.m_num_big_strengthenings);
         st.update("ba lemmas", m_stats.m_num_lemmas);
         st.update("ba subsumes", m_stats.m_num_bin_subsumes + m_stats.m_num_clause_subsumes + m_stats.m_num_pb_subsumes);
+        m_gauss.collect_statistics(st);
     }
 
     bool ba_solver::validate_unit_propagation(card const& c, literal alit) const { 
@@ -4784,6 +4867,10 @@ namespace sat {
         }
         case justification::EXT_JUSTIFICATION: {
             ext_justification_idx index = js.get_ext_justification_idx();
+            if (xor_gauss::is_gauss(index)) {
+                gauss2pb(lit, index, offset, ineq);
+                break;
+            }
             constraint& cnstr = index2constraint(index);
             constraint2pb(cnstr, lit, offset, ineq);
             break;
@@ -24,7 +24,9 @@ Revision History:
 #include "sat/sat_solver.h"
 #include "sat/sat_lookahead.h"
 #include "sat/sat_big.h"
+#include "sat/sat_xor_gauss.h"
 #include "util/small_object_allocator.h"
+#include "util/id_gen.h"
 #include "util/scoped_ptr_vector.h"
 #include "util/sorting_network.h"
 
@@ -80,7 +82,7 @@ namespace sat {
         public:
             constraint(tag_t t, unsigned id, literal l, unsigned sz, size_t osz): 
             m_tag(t), m_removed(false), m_lit(l), m_watch(null_literal), m_glue(0), m_psm(0), m_size(sz), m_obj_size(osz), m_learned(false), m_id(id), m_pure(false) {}
-            ext_constraint_idx index() const { return reinterpret_cast<ext_constraint_idx>(this); }
+            ext_constraint_idx index() const { return m_id; }
             unsigned id() const { return m_id; }
             tag_t tag() const { return m_tag; }
             literal lit() const { return m_lit; }
@@ -237,7 +239,8 @@ namespace sat {
         ptr_vector<constraint> m_constraint_to_reinit;
         unsigned_vector        m_constraint_to_reinit_lim;
         unsigned               m_constraint_to_reinit_last_sz;
-        unsigned               m_constraint_id;
+        id_gen                 m_constraint_id;
+        ptr_vector<constraint> m_id2constraint; // side table resolving ext_constraint_idx in watch lists and justifications
 
         // conflict resolution
         unsigned          m_num_marks;
@@ -254,6 +257,13 @@ namespace sat {
 
         unsigned_vector   m_pb_undef;
 
+        // Gauss-Jordan elimination over xr constraints
+        xor_gauss         m_gauss;
+        bool              m_gauss_stale;
+        void init_gauss();
+        void reset_gauss();
+        void gauss2pb(literal lit, ext_justification_idx idx, unsigned offset, ineq& p);
+
         struct ba_sort {
             typedef sat::literal pliteral;
             typedef sat::literal_vector pliteral_vector;
@@ -331,7 +341,8 @@ namespace sat {
         void remove_constraint(constraint& c, char const* reason);
 
         // constraints
-        constraint& index2constraint(size_t idx) const { return *reinterpret_cast<constraint*>(idx); }        
+        constraint& index2constraint(size_t idx) const { SASSERT(m_id2constraint.get(static_cast<unsigned>(idx), nullptr)); return *m_id2constraint[static_cast<unsigned>(idx)]; }
+        void del_constraint(constraint& c);
         void pop_constraint();
         void unwatch_literal(literal w, constraint& c);
         void watch_literal(literal w, constraint& c);
@@ -363,7 +374,7 @@ namespace sat {
         void flush_roots(constraint& c);
         void recompile(constraint& c);
         void split_root(constraint& c);
-        unsigned next_id() { return m_constraint_id++; }
+        unsigned next_id() { return m_constraint_id.mk(); }
         void set_non_learned(constraint& c);
 
 
@@ -565,7 +576,7 @@ namespace sat {
         void pop_reinit() override;
         void gc() override;
         unsigned max_var(unsigned w) const override;
-        double get_reward(literal l, ext_justification_idx idx, literal_occs_fun& occs) const override;
+        double get_reward(literal l, ext_constraint_idx idx, literal_occs_fun& occs) const override;
         bool is_extended_binary(ext_justification_idx idx, literal_vector & r) override;
         void init_use_list(ext_use_list& ul) override;
         bool is_blocked(literal l, ext_constraint_idx idx) override;
@@ -26,6 +26,7 @@ class sat_allocator {
     static const unsigned SMALL_OBJ_SIZE = 512;
     static const unsigned MASK = ((1 << PTR_ALIGNMENT) - 1);
     static const unsigned NUM_FREE = 1 + (SMALL_OBJ_SIZE >> PTR_ALIGNMENT);
+    static const unsigned CACHE_LINE_SIZE = 64;
     struct chunk {
         char  * m_curr;
         char    m_data[CHUNK_SIZE];
@@ -79,6 +80,39 @@ public:
         return result;
     }
 
+    /**
+       \brief allocate an object that does not straddle a cache line boundary.
+       Objects are placed consecutively in allocation order.
+       Freed objects are recycled only for objects of the same size class, 
+       so all objects in an allocator that only uses allocate_in_line stay within a cache line.
+    */
+    void * allocate_in_line(size_t size) {
+        SASSERT(size <= CACHE_LINE_SIZE);
+        m_alloc_size += size;
+        unsigned slot_id = free_slot_id(size);
+        if (!m_free[slot_id].empty()) {
+            void* result = m_free[slot_id].back();
+            m_free[slot_id].pop_back();
+            return result;
+        }
+        unsigned sz = align_size(size);
+        if (!m_chunks.empty()) {
+            size_t line_offset = reinterpret_cast<size_t>(m_chunk_ptr) & (CACHE_LINE_SIZE - 1);
+            if (line_offset + sz > CACHE_LINE_SIZE) 
+                m_chunk_ptr = (char*)m_chunk_ptr + (CACHE_LINE_SIZE - line_offset);
+        }
+        if (m_chunks.empty() || (char*)m_chunk_ptr + sz > (char*)m_chunks.back() + CHUNK_SIZE) {
+            m_chunks.push_back(alloc(chunk));
+            m_chunk_ptr = m_chunks.back();
+            size_t line_offset = reinterpret_cast<size_t>(m_chunk_ptr) & (CACHE_LINE_SIZE - 1);
+            if (line_offset != 0) 
+                m_chunk_ptr = (char*)m_chunk_ptr + (CACHE_LINE_SIZE - line_offset);
+        }
+        void * result = m_chunk_ptr;
+        m_chunk_ptr = (char*)m_chunk_ptr + sz;
+        return result;
+    }
+
     void deallocate(size_t size, void * p) {
         m_alloc_size -= size;
         if (size >= SMALL_OBJ_SIZE) {
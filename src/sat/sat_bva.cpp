@@ -0,0 +1,371 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    sat_bva.cpp
+
+Abstract:
+
+    Bounded variable addition.
+
+    For a literal l with clauses l \/ C1, .., l \/ Cm, the procedure
+    greedily grows a set of literals L = { l, l2, .., lk }, such that
+    all clauses lj \/ Ci are present, as long as the number of
+    clauses k*m - k - m saved by introducing a fresh variable x increases.
+
+--*/
+#include "sat/sat_bva.h"
+#include "sat/sat_simplifier.h"
+#include "sat/sat_solver.h"
+#include "util/stopwatch.h"
+#include "util/trace.h"
+
+namespace sat {
+
+    bva::bva(simplifier& _simp):
+        simp(_simp),
+        s(_simp.s),
+        m_counter(0) {
+        reset_statistics();
+    }
+
+    struct bva::report {
+        bva&      m_bva;
+        stopwatch m_watch;
+        unsigned  m_num_vars;
+        unsigned  m_num_removed;
+        unsigned  m_num_added;
+        report(bva& b):
+            m_bva(b),
+            m_num_vars(b.m_num_vars),
+            m_num_removed(b.m_num_removed),
+            m_num_added(b.m_num_added) {
+            m_watch.start();
+        }
+
+        ~report() {
+            m_watch.stop();
+            IF_VERBOSE(2,
+                       verbose_stream() << " (sat-bva :vars " << (m_bva.m_num_vars - m_num_vars)
+                       << " :removed " << (m_bva.m_num_removed - m_num_removed)
+                       << " :added " << (m_bva.m_num_added - m_num_added)
+                       << mem_stat()
+                       << m_watch << ")\n";);
+        }
+    };
+
+    void bva::operator()(int64_t limit) {
+        SASSERT(s.at_base_lvl());
+        if (s.inconsistent())
+            return;
+        report _rpt(*this);
+        m_counter = limit;
+        init();
+
+        unsigned_vector lits;
+        for (unsigned i = 0; i < m_num_occ.size(); ++i)
+            if (m_num_occ[i] >= 3)
+                lits.push_back(i);
+        std::stable_sort(lits.begin(), lits.end(), [&](unsigned a, unsigned b) { return m_num_occ[a] > m_num_occ[b]; });
+
+        for (unsigned idx : lits) {
+            if (m_counter <= 0 || s.inconsistent())
+                break;
+            s.checkpoint();
+            process(to_literal(idx));
+        }
+        finalize();
+    }
+
+    void bva::init() {
+        m_clauses.reset();
+        m_origin.reset();
+        m_removed.reset();
+        m_occ.reset();
+        m_num_occ.reset();
+        m_mark.reset();
+        m_claimed.reset();
+        unsigned num_lits = 2 * s.num_vars();
+        m_occ.resize(num_lits);
+        m_num_occ.resize(num_lits, 0);
+        m_mark.resize(num_lits, false);
+
+        auto is_assigned = [&](unsigned n, literal const* lits) {
+            for (unsigned i = 0; i < n; ++i)
+                if (s.value(lits[i]) != l_undef)
+                    return true;
+            return false;
+        };
+
+        literal lits[2];
+        for (unsigned l_idx = 0; l_idx < num_lits; ++l_idx) {
+            literal l = to_literal(l_idx);
+            for (watched const& w : s.get_wlist(~l)) {
+                if (!w.is_binary_non_learned_clause() || l.index() > w.get_literal().index())
+                    continue;
+                lits[0] = l;
+                lits[1] = w.get_literal();
+                if (!is_assigned(2, lits))
+                    add_clause(2, lits, nullptr);
+            }
+        }
+        for (clause* c : s.m_clauses) {
+            if (c->was_removed() || c->frozen() || is_assigned(c->size(), c->begin()))
+                continue;
+            add_clause(c->size(), c->begin(), c);
+        }
+    }
+
+    void bva::reserve(literal l) {
+        unsigned n = std::max(l.index(), (~l).index()) + 1;
+        if (n > m_occ.size()) {
+            m_occ.resize(n);
+            m_num_occ.resize(n, 0);
+            m_mark.resize(n, false);
+        }
+    }
+
+    unsigned bva::add_clause(unsigned n, literal const* lits, clause* origin) {
+        unsigned idx = m_clauses.size();
+        m_clauses.push_back(literal_vector(n, lits));
+        m_origin.push_back(origin);
+        m_removed.push_back(false);
+        for (unsigned i = 0; i < n; ++i) {
+            reserve(lits[i]);
+            m_occ[lits[i].index()].push_back(idx);
+            m_num_occ[lits[i].index()]++;
+        }
+        return idx;
+    }
+
+    void bva::remove_clause(unsigned idx) {
+        if (m_removed[idx])
+            return;
+        m_removed[idx] = true;
+        literal_vector const& c = m_clauses[idx];
+        for (literal l : c)
+            m_num_occ[l.index()]--;
+        clause* cls = m_origin[idx];
+        if (cls) {
+            s.detach_clause(*cls);
+            cls->set_removed(true);
+        }
+        else {
+            SASSERT(c.size() == 2);
+            s.detach_bin_clause(c[0], c[1], false);
+        }
+        ++m_num_removed;
+    }
+
+    /**
+       \brief literal of c, other than l, with the fewest occurrences.
+     */
+    literal bva::min_occ(literal l, literal_vector const& c) const {
+        literal r = null_literal;
+        for (literal lit : c)
+            if (lit != l && (r == null_literal || m_num_occ[lit.index()] < m_num_occ[r.index()]))
+                r = lit;
+        return r;
+    }
+
+    /**
+       \brief collect matches D = C \ { l } u { l' } for every clause l \/ C in m_mcls.
+     */
+    void bva::find_matches(literal l) {
+        m_matches.reset();
+        for (unsigned i = 0; i < m_mcls.size() && m_counter > 0; ++i) {
+            literal_vector const& c = m_clauses[m_mcls[i]];
+            literal lmin = min_occ(l, c);
+            for (literal lit : c)
+                m_mark[lit.index()] = lit != l;
+            for (unsigned d : m_occ[lmin.index()]) {
+                literal_vector const& cd = m_clauses[d];
+                if (m_removed[d] || cd.size() != c.size() || d == m_mcls[i])
+                    continue;
+                m_counter -= cd.size();
+                literal diff = null_literal;
+                for (literal lit : cd) {
+                    if (m_mark[lit.index()])
+                        continue;
+                    if (diff != null_literal) {
+                        diff = null_literal;
+                        break;
+                    }
+                    diff = lit;
+                }
+                // cd contains c \ { l } and the literal diff
+                if (diff == null_literal || diff == ~l || m_lits.contains(diff))
+                    continue;
+                m_matches.push_back(match(diff, i, d));
+            }
+            for (literal lit : c)
+                m_mark[lit.index()] = false;
+        }
+    }
+
+    /**
+       \brief extend m_lits by the literal that occurs in most matches,
+       provided this increases the reduction in clauses.
+     */
+    bool bva::extend() {
+        if (m_matches.empty())
+            return false;
+        std::sort(m_matches.begin(), m_matches.end(), [](match const& a, match const& b) {
+                return a.m_lit.index() < b.m_lit.index() || (a.m_lit == b.m_lit && a.m_idx < b.m_idx);
+            });
+        literal best = null_literal;
+        unsigned best_count = 0;
+        for (unsigned i = 0; i < m_matches.size(); ) {
+            literal lit = m_matches[i].m_lit;
+            unsigned count = 0, last = UINT_MAX;
+            for (; i < m_matches.size() && m_matches[i].m_lit == lit; ++i) {
+                if (m_matches[i].m_idx != last)
+                    ++count;
+                last = m_matches[i].m_idx;
+            }
+            if (count > best_count) {
+                best = lit;
+                best_count = count;
+            }
+        }
+        if (reduction(m_lits.size() + 1, best_count) <= reduction(m_lits.size(), m_mcls.size()))
+            return false;
+
+        // a clause is the partner of at most one clause in m_mcls,
+        // duplicate clauses can otherwise match several of them.
+        if (m_claimed.size() < m_clauses.size())
+            m_claimed.resize(m_clauses.size(), false);
+        for (unsigned_vector const& ps : m_partners)
+            for (unsigned c : ps)
+                m_claimed[c] = true;
+        unsigned_vector mcls;
+        vector<unsigned_vector> partners;
+        unsigned last = UINT_MAX;
+        for (match const& m : m_matches) {
+            if (m.m_lit != best || m.m_idx == last || m_claimed[m.m_clause])
+                continue;
+            last = m.m_idx;
+            m_claimed[m.m_clause] = true;
+            mcls.push_back(m_mcls[m.m_idx]);
+            partners.push_back(m_partners[m.m_idx]);
+            partners.back().push_back(m.m_clause);
+        }
+        for (unsigned_vector const& ps : m_partners)
+            for (unsigned c : ps)
+                m_claimed[c] = false;
+        for (unsigned_vector const& ps : partners)
+            m_claimed[ps.back()] = false;
+        if (reduction(m_lits.size() + 1, mcls.size()) <= reduction(m_lits.size(), m_mcls.size()))
+            return false;
+        m_mcls.swap(mcls);
+        m_partners.swap(partners);
+        m_lits.push_back(best);
+        return true;
+    }
+
+    void bva::process(literal l) {
+        m_lits.reset();
+        m_mcls.reset();
+        m_partners.reset();
+        m_lits.push_back(l);
+        for (unsigned c : m_occ[l.index()]) {
+            if (m_removed[c])
+                continue;
+            m_mcls.push_back(c);
+            m_partners.push_back(unsigned_vector());
+            m_partners.back().push_back(c);
+        }
+        if (m_mcls.size() < 3)
+            return;
+        while (m_counter > 0) {
+            find_matches(l);
+            if (!extend())
+                break;
+        }
+        if (m_lits.size() < 2 || reduction(m_lits.size(), m_mcls.size()) <= 0)
+            return;
+        replace();
+    }
+
+    /**
+       \brief replace the clauses lj \/ Ci by lj \/ x and ~x \/ Ci for a fresh variable x.
+     */
+    void bva::replace() {
+        literal l = m_lits[0];
+        bool_var v = s.mk_var(false, true);
+        literal x(v, false);
+        reserve(x);
+        ++m_num_vars;
+        TRACE("sat_bva", tout << "bva " << x << " := " << m_lits << "\n";);
+
+        // x is true if some literal of L is false, consistent with the clauses lj \/ x.
+        model_converter::entry& e = s.m_mc.mk(model_converter::BVA, v);
+        for (literal lit : m_lits)
+            s.m_mc.insert(e, x, lit);
+
+        literal_vector lits;
+        for (unsigned_vector const& ps : m_partners)
+            for (unsigned c : ps)
+                remove_clause(c);
+
+        for (literal lit : m_lits) {
+            lits.reset();
+            lits.push_back(lit);
+            lits.push_back(x);
+            add_clause(2, lits.c_ptr(), nullptr);
+            s.mk_clause(2, lits.c_ptr(), false);
+            ++m_num_added;
+        }
+        for (unsigned c : m_mcls) {
+            lits.reset();
+            lits.push_back(~x);
+            for (literal lit : m_clauses[c])
+                if (lit != l)
+                    lits.push_back(lit);
+            clause* cls = s.mk_clause(lits.size(), lits.c_ptr(), false);
+            // the solver may simplify a longer clause, it is then not tracked
+            // because it cannot be removed by detaching a binary clause.
+            if (cls || lits.size() == 2)
+                add_clause(lits.size(), lits.c_ptr(), cls);
+            ++m_num_added;
+        }
+    }
+
+    /**
+       \brief reclaim the clauses that were replaced.
+     */
+    void bva::finalize() {
+        ptr_vector<clause> removed;
+        clause_vector& clauses = s.m_clauses;
+        unsigned j = 0;
+        for (clause* c : clauses) {
+            if (c->was_removed())
+                removed.push_back(c);
+            else
+                clauses[j++] = c;
+        }
+        clauses.shrink(j);
+        for (clause* c : removed)
+            s.del_clause(*c);
+        m_clauses.finalize();
+        m_origin.finalize();
+        m_removed.finalize();
+        m_occ.finalize();
+        m_num_occ.finalize();
+        m_mark.finalize();
+        m_matches.finalize();
+    }
+
+    void bva::collect_statistics(statistics& st) const {
+        st.update("sat bva vars", m_num_vars);
+        st.update("sat bva removed", m_num_removed);
+        st.update("sat bva added", m_num_added);
+    }
+
+    void bva::reset_statistics() {
+        m_num_vars = 0;
+        m_num_removed = 0;
+        m_num_added = 0;
+    }
+}
@@ -0,0 +1,86 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    sat_bva.h
+
+Abstract:
+
+    Bounded variable addition.
+
+    Replaces a set of clauses { l \/ C : l in L, C in M }
+    by the clauses { l \/ x : l in L } and { ~x \/ C : C in M }
+    for a fresh variable x when it reduces the number of clauses.
+    The typical candidates are quadratic encodings of
+    cardinality constraints.
+
+    Manthey, Heule, Biere: Automated Reencoding of Boolean Formulas, HVC 2012.
+
+--*/
+#pragma once
+
+#include "sat/sat_types.h"
+#include "util/statistics.h"
+
+namespace sat {
+    class solver;
+    class simplifier;
+
+    class bva {
+        struct report;
+
+        // clause D matches clause C of m_mcls if D = C \ { l } u { m_lit }
+        struct match {
+            literal  m_lit;
+            unsigned m_idx;      // index into m_mcls
+            unsigned m_clause;   // D
+            match(literal l, unsigned idx, unsigned c): m_lit(l), m_idx(idx), m_clause(c) {}
+        };
+
+        simplifier&              simp;
+        solver&                  s;
+        int64_t                  m_counter;
+
+        // local copy of the irredundant clauses
+        vector<literal_vector>   m_clauses;
+        ptr_vector<clause>       m_origin;     // nullptr for binary clauses
+        bool_vector              m_removed;
+        vector<unsigned_vector>  m_occ;        // literal -> clauses containing literal
+        unsigned_vector          m_num_occ;    // literal -> number of live clauses containing literal
+        bool_vector              m_mark;
+        bool_vector              m_claimed;    // clauses that are partners of a clause in m_mcls
+
+        literal_vector           m_lits;       // L
+        unsigned_vector          m_mcls;       // clauses l \/ C for the first literal l in L
+        vector<unsigned_vector>  m_partners;   // clauses l_j \/ C for each clause in m_mcls and literal l_j in L
+        svector<match>           m_matches;
+
+        // stats
+        unsigned                 m_num_vars;
+        unsigned                 m_num_removed;
+        unsigned                 m_num_added;
+
+        void init();
+        void reserve(literal l);
+        unsigned add_clause(unsigned n, literal const* lits, clause* origin);
+        void remove_clause(unsigned idx);
+        literal min_occ(literal l, literal_vector const& c) const;
+        void find_matches(literal l);
+        bool extend();
+        void process(literal l);
+        void replace();
+        void finalize();
+        static int reduction(unsigned num_lits, unsigned num_clauses) {
+            return static_cast<int>(num_lits * num_clauses) - static_cast<int>(num_lits + num_clauses);
+        }
+
+    public:
+        bva(simplifier& simp);
+
+        void operator()(int64_t limit);
+
+        void collect_statistics(statistics& st) const;
+        void reset_statistics();
+    };
+}
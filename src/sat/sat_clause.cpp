@@ -32,6 +32,10 @@ namespace sat {
         m_used(false),
         m_frozen(false),
         m_reinit_stack(false),
+        m_small(false),
+        m_arena_queue(false),
+        m_vivified(false),
+        m_tier(TIER_LOCAL),
         m_inact_rounds(0),
         m_glue(255),
         m_psm(255) {
@@ -115,23 +119,11 @@ namespace sat {
     }
 
     clause_offset clause::get_new_offset() const {
-        unsigned o1 = m_lits[0].index();
-#if defined(__LP64__) || defined(_WIN64)
-        if (sizeof(clause_offset) == 8) {
-            unsigned o2 = m_lits[1].index();
-            return (clause_offset)o1 + (((clause_offset)o2) << 32);
-        }        
-#endif
-        return (clause_offset)o1;
+        return static_cast<clause_offset>(m_lits[0].index());
     }
 
     void clause::set_new_offset(clause_offset offset) {
-        m_lits[0] = to_literal(static_cast<unsigned>(offset));
-#if defined(__LP64__) || defined(_WIN64)
-        if (sizeof(offset) == 8) {
-            m_lits[1] = to_literal(static_cast<unsigned>(offset >> 32));
-        }
-#endif
+        m_lits[0] = to_literal(offset);
     }
 
 
@@ -157,50 +149,99 @@ namespace sat {
     }
 
     clause_allocator::clause_allocator():
-        m_allocator("clause-allocator") {
+        m_allocator("clause-allocator"),
+        m_small_idx(false),
+        m_use_small_arena(false) {
     }
 
     void clause_allocator::finalize() {
         m_allocator.reset();
+        m_small_allocator[0].reset();
+        m_small_allocator[1].reset();
+        m_id2clause.reset();
+        m_id_gen.reset();
     }
 
-    clause * clause_allocator::get_clause(clause_offset cls_off) const {
-        SASSERT(cls_off == reinterpret_cast<clause_offset>(reinterpret_cast<clause*>(cls_off)));
-        return reinterpret_cast<clause *>(cls_off);
+    size_t clause_allocator::get_allocation_size() const {
+        return 
+            m_allocator.get_allocation_size() + 
+            m_small_allocator[0].get_allocation_size() + 
+            m_small_allocator[1].get_allocation_size();
     }
 
-    clause_offset clause_allocator::get_offset(clause const * cls) const {
-        SASSERT(cls == reinterpret_cast<clause *>(reinterpret_cast<size_t>(cls)));
-        return reinterpret_cast<size_t>(cls);
+    void * clause_allocator::allocate(unsigned num_lits, bool learned) {
+        size_t size = clause::get_obj_size(num_lits);
+        if (is_small(num_lits, learned)) 
+            return m_small_allocator[m_small_idx].allocate_in_line(size);
+        return m_allocator.allocate(size);
     }
 
     clause * clause_allocator::mk_clause(unsigned num_lits, literal const * lits, bool learned) {
-        size_t size = clause::get_obj_size(num_lits);
-        void * mem = m_allocator.allocate(size);
+        void * mem = allocate(num_lits, learned);
         clause * cls = new (mem) clause(m_id_gen.mk(), num_lits, lits, learned);
+        cls->m_small = is_small(num_lits, learned);
         TRACE("sat_clause", tout << "alloc: " << cls->id() << " " << *cls << " " << (learned?"l":"a") << "\n";);
         SASSERT(!learned || cls->is_learned());
+        register_clause(cls);
         return cls;
     }
 
     clause * clause_allocator::copy_clause(clause const& other) {
-        size_t size = clause::get_obj_size(other.size());
-        void * mem = m_allocator.allocate(size);
+        void * mem = allocate(other.size(), other.is_learned());
         clause * cls = new (mem) clause(m_id_gen.mk(), other.size(), other.m_lits, other.is_learned());
+        cls->m_small  = is_small(other.size(), other.is_learned());
         cls->m_reinit_stack = other.on_reinit_stack();
         cls->m_glue   = other.glue();
         cls->m_psm    = other.psm();
         cls->m_frozen = other.frozen();
+        cls->m_tier   = other.m_tier;
+        cls->m_vivified = other.m_vivified;
+        cls->m_inact_rounds = other.m_inact_rounds;
         cls->m_approx = other.approx();
+        register_clause(cls);
         return cls;
     }
 
     void clause_allocator::del_clause(clause * cls) {
         TRACE("sat_clause", tout << "delete: " << cls->id() << " " << *cls << "\n";);
         m_id_gen.recycle(cls->id());
+        m_id2clause[cls->id()] = nullptr;
         size_t size = clause::get_obj_size(cls->m_capacity);
+        bool small = cls->m_small;
         cls->~clause();
-        m_allocator.deallocate(size, cls);
+        if (small)
+            m_small_allocator[m_small_idx].deallocate(size, cls);
+        else
+            m_allocator.deallocate(size, cls);
+    }
+
+    void clause_allocator::relocate_small(clause* cls) {
+        size_t size = cls->get_size();
+        void * mem = m_small_allocator[!m_small_idx].allocate_in_line(size);
+        memcpy(mem, cls, size);
+        clause* cls2 = static_cast<clause*>(mem);
+        cls2->m_arena_queue = false;
+        m_id2clause[cls->id()] = cls2;
+    }
+
+    void clause_allocator::reorder_small_arena(unsigned_vector const& order) {
+        ptr_vector<clause> small;
+        for (clause* cls : m_id2clause) 
+            if (cls && cls->m_small) 
+                small.push_back(cls);
+        for (unsigned id : order) {
+            clause* cls = m_id2clause.get(id, nullptr);
+            if (cls && cls->m_small && cls->m_arena_queue) 
+                relocate_small(cls);
+        }
+        for (clause* cls : small) 
+            if (m_id2clause[cls->id()] == cls) 
+                relocate_small(cls);
+    }
+
+    void clause_allocator::release_small_arena() {
+        m_small_allocator[m_small_idx].reset();
+        m_small_idx = !m_small_idx;
     }
 
     std::ostream & operator<<(std::ostream & out, clause const & c) {
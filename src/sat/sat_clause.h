@@ -37,6 +37,17 @@ namespace sat {
 
     std::ostream & operator<<(std::ostream & out, clause const & c);
 
+    /**
+       \brief Tiers of the learned clause database.
+       Core clauses are kept, tier2 clauses are demoted to the local tier
+       when they are inactive, and the local tier is reduced by activity.
+    */
+    enum clause_tier {
+        TIER_CORE  = 0,
+        TIER_2     = 1,
+        TIER_LOCAL = 2
+    };
+
     class clause {
         friend class clause_allocator;
         friend class tmp_clause;
@@ -50,7 +61,11 @@ namespace sat {
         unsigned           m_used:1;
         unsigned           m_frozen:1;
         unsigned           m_reinit_stack:1;
-        unsigned           m_inact_rounds:8;
+        unsigned           m_small:1;        // allocated in the cache line aligned arena of clause_allocator
+        unsigned           m_arena_queue:1;  // queued for relocation in propagation order
+        unsigned           m_vivified:1;     // learned clause was already vivified
+        unsigned           m_tier:2;         // clause_tier of learned clause
+        unsigned           m_inact_rounds:5;
         unsigned           m_glue:8;
         unsigned           m_psm:8;  // transient field used during gc
         literal            m_lits[0];
@@ -62,6 +77,7 @@ namespace sat {
         unsigned id() const { return m_id; }
         unsigned size() const { return m_size; }
         unsigned capacity() const { return m_capacity; }
+        size_t bytes() const { return get_size(); }
         literal & operator[](unsigned idx) { SASSERT(idx < m_size); return m_lits[idx]; }
         literal const & operator[](unsigned idx) const { SASSERT(idx < m_size); return m_lits[idx]; }
         bool is_learned() const { return m_learned; }
@@ -90,6 +106,10 @@ namespace sat {
         void inc_inact_rounds() { m_inact_rounds++; }
         void reset_inact_rounds() { m_inact_rounds = 0; }
         unsigned inact_rounds() const { return m_inact_rounds; }
+        clause_tier tier() const { return static_cast<clause_tier>(m_tier); }
+        void set_tier(clause_tier t) { m_tier = t; }
+        bool was_vivified() const { return m_vivified; }
+        void set_vivified(bool f) { m_vivified = f; }
         bool frozen() const { return m_frozen; }
         void freeze() { SASSERT(is_learned()); SASSERT(!frozen()); m_frozen = true; }
         void unfreeze() { SASSERT(is_learned()); SASSERT(frozen()); m_frozen = false; }
@@ -103,6 +123,10 @@ namespace sat {
 
         bool on_reinit_stack() const { return m_reinit_stack; }
         void set_reinit_stack(bool f) { m_reinit_stack = f; }
+
+        bool in_small_arena() const { return m_small; }
+        bool on_arena_queue() const { return m_arena_queue; }
+        void set_arena_queue(bool f) { SASSERT(in_small_arena()); m_arena_queue = f; }
     };
 
     std::ostream & operator<<(std::ostream & out, clause_vector const & cs);
@@ -134,19 +158,39 @@ namespace sat {
 
     /**
        \brief Simple clause allocator that allows uint (32bit integers) to be used to reference clauses (even in 64bit machines).
+       The offset of a clause is its id, and m_id2clause maps offsets back to clauses.
+       This keeps watch list entries (see sat_watched.h) at 8 bytes.
     */
     class clause_allocator {
         sat_allocator    m_allocator;
+        sat_allocator    m_small_allocator[2]; // cache line aligned arenas for short learned clauses
+        bool             m_small_idx;
+        bool             m_use_small_arena;
         id_gen           m_id_gen;
+        ptr_vector<clause> m_id2clause;
+        void register_clause(clause* cls) { m_id2clause.setx(cls->id(), cls, nullptr); }
+        bool is_small(unsigned num_lits, bool learned) const { return m_use_small_arena && learned && 3 <= num_lits && num_lits <= 8; }
+        void * allocate(unsigned num_lits, bool learned);
+        void relocate_small(clause* cls);
     public:
         clause_allocator();
         void          finalize();
-        size_t        get_allocation_size() const { return m_allocator.get_allocation_size(); }
-        clause *      get_clause(clause_offset cls_off) const;
-        clause_offset get_offset(clause const * ptr) const;
+        size_t        get_allocation_size() const;
+        void          set_small_arena(bool f) { m_use_small_arena = f; }
+        clause *      get_clause(clause_offset cls_off) const { SASSERT(m_id2clause.get(cls_off, nullptr)); return m_id2clause[cls_off]; }
+        clause_offset get_offset(clause const * ptr) const { SASSERT(get_clause(ptr->id()) == ptr); return ptr->id(); }
         clause *      mk_clause(unsigned num_lits, literal const * lits, bool learned);
         clause *      copy_clause(clause const& other);
         void          del_clause(clause * cls);
+
+        /**
+           \brief move all clauses of the small arena into the spare arena.
+           Clauses listed in order come first, the remaining ones follow.
+           Offsets are preserved, but pointers to the moved clauses must be 
+           refreshed using get_clause(c->id()) before calling release_small_arena.
+        */
+        void          reorder_small_arena(unsigned_vector const& order);
+        void          release_small_arena();
     };
 
     /**
@@ -16,6 +16,8 @@ Author:
 Revision History:
 
 --*/
+#include <atomic>
+#include "util/warning.h"
 #include "sat/sat_config.h"
 #include "sat/sat_types.h"
 #include "sat/sat_params.hpp"
@@ -89,8 +91,11 @@ namespace sat {
         
         m_max_conflicts   = p.max_conflicts();
         m_num_threads     = p.threads();
+        m_par_max_size    = p.par_max_size();
+        m_par_max_glue    = p.par_max_glue();
         m_ddfw_search     = p.ddfw_search();
         m_ddfw_threads    = p.ddfw_threads();
+        m_ddfw_elite_pool = p.ddfw_elite_pool();
         m_prob_search     = p.prob_search();
         m_local_search    = p.local_search();
         m_local_search_threads = p.local_search_threads();
@@ -172,14 +177,25 @@ namespace sat {
             m_gc_strategy = GC_PSM;
         else if (s == symbol("psm_glue"))
             m_gc_strategy = GC_PSM_GLUE;
+        else if (s == symbol("tiered"))
+            m_gc_strategy = GC_TIERED;
         else 
             throw sat_param_exception("invalid gc strategy");
         m_gc_initial      = p.gc_initial();
         m_gc_increment    = p.gc_increment();
         m_gc_small_lbd    = p.gc_small_lbd();
-        m_gc_k            = std::min(255u, p.gc_k());
+        // inactivity is counted in 5 bits, such that clauses exceeding 30 rounds can be detected
+        m_gc_k            = std::min(30u, p.gc_k());
+        m_gc_tier1_glue   = p.gc_tier1_glue();
+        m_gc_tier2_glue   = p.gc_tier2_glue();
+        m_gc_tier2_rounds = std::min(30u, p.gc_tier2_rounds());
+        // parameters are updated often, the bound is reported once.
+        static std::atomic<bool> s_gc_warned(false);
+        if ((p.gc_k() > 30 || p.gc_tier2_rounds() > 30) && !s_gc_warned.exchange(true))
+            warning_msg("sat.gc.k and sat.gc.tier2_rounds are limited to 30 rounds");
         m_gc_burst        = p.gc_burst();
         m_gc_defrag       = p.gc_defrag();
+        m_gc_small_arena  = p.gc_small_arena();
 
         m_force_cleanup   = p.force_cleanup();
 
@@ -194,6 +210,7 @@ namespace sat {
         m_drat_file       = p.drat_file();
         m_drat            = (m_drat_check_unsat || m_drat_file != symbol("") || m_drat_check_sat) && p.threads() == 1;
         m_drat_binary     = p.drat_binary();
+        m_drat_checkpoint = p.drat_checkpoint();
         m_drat_activity   = p.drat_activity();
         m_dyn_sub_res     = p.dyn_sub_res();
 
@@ -244,6 +261,8 @@ namespace sat {
         
         m_card_solver = p.cardinality_solver();
         m_xor_solver = false; // prevent users from playing with this option
+        m_xor_gauss = p.xor_gauss();
+        m_xor_gauss_max_vars = p.xor_gauss_max_vars();
 
         sat_simplifier_params sp(_p);
         m_elim_vars = sp.elim_vars();
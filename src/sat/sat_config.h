@@ -43,7 +43,8 @@ namespace sat {
         GC_PSM,
         GC_GLUE,
         GC_GLUE_PSM,
-        GC_PSM_GLUE
+        GC_PSM_GLUE,
+        GC_TIERED
     };
 
     enum branching_heuristic {
@@ -110,8 +111,11 @@ namespace sat {
         bool               m_enable_pre_simplify;
         unsigned           m_max_conflicts;
         unsigned           m_num_threads;
+        unsigned           m_par_max_size;
+        unsigned           m_par_max_glue;
         bool               m_ddfw_search;
         unsigned           m_ddfw_threads;
+        unsigned           m_ddfw_elite_pool;
         bool               m_prob_search;
         unsigned           m_local_search_threads;
         bool               m_local_search;
@@ -158,8 +162,12 @@ namespace sat {
         unsigned           m_gc_increment;
         unsigned           m_gc_small_lbd;
         unsigned           m_gc_k;
+        unsigned           m_gc_tier1_glue;
+        unsigned           m_gc_tier2_glue;
+        unsigned           m_gc_tier2_rounds;
         bool               m_gc_burst;
         bool               m_gc_defrag;
+        bool               m_gc_small_arena;
 
         bool               m_force_cleanup;
 
@@ -179,9 +187,12 @@ namespace sat {
         bool               m_drat_check_unsat;
         bool               m_drat_check_sat;
         bool               m_drat_activity;
+        unsigned           m_drat_checkpoint;
         
         bool               m_card_solver;
         bool               m_xor_solver;
+        bool               m_xor_gauss;
+        unsigned           m_xor_gauss_max_vars;
         pb_resolve         m_pb_resolve;
         pb_lemma_format    m_pb_lemma_format;
         
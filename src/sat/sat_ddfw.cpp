@@ -133,6 +133,8 @@ namespace sat {
         for (literal lit : *cls) {
             m_use_list.reserve(lit.index()+1);
             m_vars.reserve(lit.var()+1);
+            m_reward.reserve(lit.var()+1);
+            m_make_count.reserve(lit.var()+1);
             m_use_list[lit.index()].push_back(idx);
         }
     }
@@ -310,10 +312,8 @@ namespace sat {
     }
 
     void ddfw::init_clause_data() {
-        for (unsigned v = 0; v < num_vars(); ++v) {
-            make_count(v) = 0;
-            reward(v) = 0;
-        }
+        m_reward.fill(0);
+        m_make_count.fill(0);
         m_unsat_vars.reset();
         m_unsat.reset();
         unsigned sz = m_clauses.size();
@@ -349,7 +349,8 @@ namespace sat {
     }
 
     void ddfw::do_restart() {        
-        reinit_values();
+        if (!reinit_values_from_elite())
+            reinit_values();
         init_clause_data();
         m_restart_next += m_config.m_restart_base*get_luby(++m_restart_count);
     }
@@ -374,6 +375,28 @@ namespace sat {
         }        
     }
 
+    /**
+       \brief with m_elite_pct probability restart from one of the best assignments 
+       found by the ddfw threads running in parallel.
+    */
+    bool ddfw::reinit_values_from_elite() {
+        unsigned cost = 0;
+        if (!m_par || m_rand(100) >= m_config.m_elite_pct || !m_par->get_elite(m_rand, cost, m_elite_values))
+            return false;
+        unsigned n = std::min(num_vars(), m_elite_values.size());
+        for (unsigned v = 0; v < n; ++v)
+            value(v) = m_elite_values[v];
+        ++m_elite_restarts;
+        return true;
+    }
+
+    void ddfw::publish_best_values() {
+        m_elite_values.reset();
+        for (unsigned v = 0; v < num_vars(); ++v)
+            m_elite_values.push_back(value(v));
+        m_par->publish_elite(m_unsat.size(), m_elite_values);
+    }
+
     bool ddfw::should_parallel_sync() {
         return m_par != nullptr && m_flips >= m_parsync_next;
     }
@@ -411,6 +434,7 @@ namespace sat {
             }
         }
         if (m_unsat.size() < m_min_sz) {
+            if (m_par) publish_best_values();
             m_models.reset();
             // skip saving the first model.
             for (unsigned v = 0; v < num_vars(); ++v) {
@@ -586,6 +610,13 @@ namespace sat {
         m_config.m_use_reward_zero_pct = p.ddfw_use_reward_pct();
         m_config.m_reinit_base = p.ddfw_reinit_base();
         m_config.m_restart_base = p.ddfw_restart_base();        
+        m_config.m_elite_pct = p.ddfw_elite_pct();
+    }
+
+    void ddfw::collect_statistics(statistics& st) const {
+        st.update("sat ddfw flips", static_cast<double>(m_flips));
+        st.update("sat ddfw restarts", m_restart_count);
+        st.update("sat ddfw elite restarts", m_elite_restarts);
     }
     
 }
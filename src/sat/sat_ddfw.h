@@ -52,6 +52,7 @@ namespace sat {
             unsigned m_restart_base;
             unsigned m_reinit_base;
             unsigned m_parsync_base;
+            unsigned m_elite_pct;
             double   m_itau;
             void reset() {
                 m_init_clause_weight = 8;
@@ -60,15 +61,14 @@ namespace sat {
                 m_restart_base = 100333;
                 m_reinit_base = 10000;
                 m_parsync_base = 333333;
+                m_elite_pct = 30;
                 m_itau = 0.5;
             }
         };
 
         struct var_info {
-            var_info(): m_value(false), m_reward(0), m_make_count(0), m_bias(0), m_reward_avg(1e-5) {}
+            var_info(): m_value(false), m_bias(0), m_reward_avg(1e-5) {}
             bool     m_value;
-            int      m_reward;
-            unsigned m_make_count;
             int      m_bias;
             ema      m_reward_avg;
         };
@@ -79,6 +79,8 @@ namespace sat {
         svector<clause_info> m_clauses;
         literal_vector       m_assumptions;        
         svector<var_info>    m_vars;        // var -> info
+        svector<int>         m_reward;      // var -> reward, kept apart from m_vars for dense updates
+        unsigned_vector      m_make_count;  // var -> number of false clauses containing var
         svector<double>      m_probs;       // var -> probability of flipping
         svector<double>      m_scores;      // reward -> score
         model                m_model;       // var -> best assignment
@@ -94,6 +96,8 @@ namespace sat {
         unsigned         m_restart_count, m_reinit_count, m_parsync_count;
         uint64_t         m_restart_next,  m_reinit_next,  m_parsync_next;
         uint64_t         m_flips, m_last_flips, m_shifts;
+        unsigned         m_elite_restarts;
+        bool_vector      m_elite_values;
         unsigned         m_min_sz;
         hashtable<unsigned, unsigned_hash, default_eq<unsigned>> m_models;
         stopwatch        m_stopwatch;
@@ -118,15 +122,15 @@ namespace sat {
 
         inline unsigned num_vars() const { return m_vars.size(); }
 
-        inline unsigned& make_count(bool_var v) { return m_vars[v].m_make_count; }
+        inline unsigned& make_count(bool_var v) { return m_make_count[v]; }
 
         inline bool& value(bool_var v) { return m_vars[v].m_value; }
 
         inline bool value(bool_var v) const { return m_vars[v].m_value; }
 
-        inline int& reward(bool_var v) { return m_vars[v].m_reward; }
+        inline int& reward(bool_var v) { return m_reward[v]; }
 
-        inline int reward(bool_var v) const { return m_vars[v].m_reward; }
+        inline int reward(bool_var v) const { return m_reward[v]; }
 
         inline int& bias(bool_var v) { return m_vars[v].m_bias; }
 
@@ -176,10 +180,12 @@ namespace sat {
         bool should_restart();
         void do_restart();
         void reinit_values();
+        bool reinit_values_from_elite();
 
         // parallel integration
         bool should_parallel_sync();
         void do_parallel_sync();
+        void publish_best_values();
 
         void log();
 
@@ -195,7 +201,7 @@ namespace sat {
 
     public:
 
-        ddfw(): m_par(nullptr) {}
+        ddfw(): m_elite_restarts(0), m_par(nullptr) {}
 
         ~ddfw() override;
 
@@ -217,7 +223,7 @@ namespace sat {
         unsigned num_non_binary_clauses() const override { return m_num_non_binary_clauses; }
         void reinit(solver& s) override;
 
-        void collect_statistics(statistics& st) const override {} 
+        void collect_statistics(statistics& st) const override;
 
         double get_priority(bool_var v) const override { return m_probs[v]; }
     };
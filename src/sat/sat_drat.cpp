@@ -21,9 +21,73 @@ Notes:
 --*/
 #include "sat_solver.h"
 #include "sat_drat.h"
+#ifdef _WINDOWS
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
 
 
 namespace sat {
+
+    drat_buffer::drat_buffer(char const* file_name, unsigned capacity):
+        m_size(0),
+        m_capacity(capacity) {
+#ifdef _WINDOWS
+        m_fd = _open(file_name, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        m_fd = open(file_name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+        m_buffer = alloc_svect(char, m_capacity);
+    }
+
+    drat_buffer::~drat_buffer() {
+        flush();
+        if (m_fd >= 0) {
+#ifdef _WINDOWS
+            _close(m_fd);
+#else
+            close(m_fd);
+#endif
+        }
+        dealloc_svect(m_buffer);
+    }
+
+    void drat_buffer::flush() {
+        char const* data = m_buffer;
+        unsigned sz = m_size;
+        m_size = 0;
+        while (m_fd >= 0 && sz > 0) {
+#ifdef _WINDOWS
+            int n = _write(m_fd, data, sz);
+#else
+            ssize_t n = write(m_fd, data, sz);
+            if (n < 0 && errno == EINTR)
+                continue;
+#endif
+            if (n <= 0) {
+                IF_VERBOSE(0, verbose_stream() << "(sat.drat could not write proof)\n");
+                return;
+            }
+            data += n;
+            sz -= static_cast<unsigned>(n);
+        }
+    }
+
+    void drat_buffer::put_varint(unsigned v) {
+        do {
+            unsigned char ch = static_cast<unsigned char>(v & 127);
+            v >>= 7;
+            if (v) ch |= 128;
+            put(ch);
+        }
+        while (v);
+    }
+
     drat::drat(solver& s):
         s(s),
         m_out(nullptr),
@@ -34,13 +98,22 @@ namespace sat {
         m_check_unsat(false),
         m_check_sat(false),
         m_check(false),
-        m_activity(false)
+        m_activity(false),
+        m_checkpoint(0),
+        m_next_checkpoint(0)
     {
         if (s.get_config().m_drat && s.get_config().m_drat_file != symbol()) {
-            auto mode = s.get_config().m_drat_binary ? (std::ios_base::binary | std::ios_base::out | std::ios_base::trunc) : std::ios_base::out;
-            m_out = alloc(std::ofstream, s.get_config().m_drat_file.str(), mode);
-            if (s.get_config().m_drat_binary) {
-                std::swap(m_out, m_bout);
+            if (s.get_config().m_drat_binary) 
+                m_bout = alloc(drat_buffer, s.get_config().m_drat_file.bare_str(), 1 << 20);
+            else 
+                m_out = alloc(std::ofstream, s.get_config().m_drat_file.str(), std::ios_base::out);
+            if ((m_bout && !m_bout->is_open()) || (m_out && !*m_out)) {
+                dealloc(m_out);
+                dealloc(m_bout);
+                m_out = nullptr;
+                m_bout = nullptr;
+                std::string msg = "could not open drat file " + s.get_config().m_drat_file.str();
+                throw solver_exception(msg.c_str());
             }
         }
     }
@@ -66,6 +139,8 @@ namespace sat {
         m_check_sat = s.get_config().m_drat_check_sat;
         m_check = m_check_unsat || m_check_sat;
         m_activity = s.get_config().m_drat_activity;
+        m_checkpoint = s.get_config().m_drat_checkpoint;
+        m_next_checkpoint = m_num_add + m_num_del + m_checkpoint;
     }
 
     std::ostream& operator<<(std::ostream& out, drat::status st) {
@@ -129,6 +204,10 @@ namespace sat {
         (*m_out) << "\n";
     }
 
+    /**
+       \brief binary DRAT: a step is 'a' or 'd' followed by the variable length 
+       encoding of 2*var + sign for each literal and terminated by 0.
+    */
     void drat::bdump(unsigned n, literal const* c, status st) {
         unsigned char ch = 0;
         switch (st) {
@@ -138,27 +217,10 @@ namespace sat {
         case status::deleted: ch = 'd'; break;
         default: UNREACHABLE(); break;
         }
-        char buffer[10000];
-        int len = 0;
-        buffer[len++] = ch;
-
-        for (unsigned i = 0; i < n; ++i) {
-            literal lit = c[i];
-            unsigned v = 2 * lit.var() + (lit.sign() ? 1 : 0);
-            do {
-                ch = static_cast<unsigned char>(v & 255);
-                v >>= 7;
-                if (v) ch |= 128;
-                buffer[len++] = ch;
-                if (len == sizeof(buffer)) {
-                    m_bout->write(buffer, len);
-                    len = 0;
-                }
-            }
-            while (v);
-        }
-        buffer[len++] = 0;
-        m_bout->write(buffer, len);
+        m_bout->put(ch);
+        for (unsigned i = 0; i < n; ++i) 
+            m_bout->put_varint(2 * c[i].var() + (c[i].sign() ? 1 : 0));
+        m_bout->put(0);
     }
 
     bool drat::is_cleaned(clause& c) const {
@@ -275,6 +337,11 @@ namespace sat {
             if (n > 1) del_watch(c, c[1]);
             return;
         }
+        attach(c);
+    }
+
+    void drat::attach(clause& c) {
+        unsigned n = c.size();
         unsigned num_watch = 0;
         literal l1, l2;
         for (unsigned i = 0; i < n; ++i) {
@@ -308,6 +375,60 @@ namespace sat {
         }
     }
 
+    /**
+       \brief drop proof steps that are no longer needed for checking.
+       A deletion step is removed together with the clause it deletes, 
+       and the watch lists are rebuilt from the remaining clauses.
+       The proof that is written to file is not affected.
+    */
+    void drat::checkpoint() {
+        m_next_checkpoint = m_num_add + m_num_del + m_checkpoint;
+        unsigned sz = m_proof.size();
+        u_map<unsigned_vector> live;
+        for (unsigned i = 0; i < sz; ++i) {
+            clause* c = m_proof[i];
+            unsigned h = c->size();
+            for (literal lit : *c) h += hash_u(lit.index());
+            if (m_status[i] != status::deleted) {
+                live.insert_if_not_there(h, unsigned_vector()).push_back(i);
+                continue;
+            }
+            auto* e = live.find_core(h);
+            if (!e) 
+                continue;
+            unsigned_vector& idxs = e->get_data().m_value;
+            for (unsigned k = idxs.size(); k-- > 0; ) {
+                unsigned j = idxs[k];
+                if (match(c->size(), c->begin(), *m_proof[j])) {
+                    m_alloc.del_clause(m_proof[j]);
+                    m_alloc.del_clause(c);
+                    m_proof[j] = nullptr;
+                    m_proof[i] = nullptr;
+                    idxs[k] = idxs.back();
+                    idxs.pop_back();
+                    break;
+                }
+            }
+        }
+        unsigned j = 0;
+        for (unsigned i = 0; i < sz; ++i) {
+            if (m_proof[i]) {
+                m_proof[j] = m_proof[i];
+                m_status[j] = m_status[i];
+                ++j;
+            }
+        }
+        IF_VERBOSE(10, verbose_stream() << "(sat.drat.checkpoint :steps " << sz << " :kept " << j << ")\n";);
+        m_proof.shrink(j);
+        m_status.shrink(j);
+        m_watched_clauses.reset();
+        for (watch& w : m_watches) 
+            w.finalize();
+        for (unsigned i = 0; i < j; ++i) 
+            if (m_status[i] != status::deleted && m_proof[i]->size() > 1) 
+                attach(*m_proof[i]);
+    }
+
     void drat::del_watch(clause& c, literal l) {
         watch& w = m_watches[(~l).index()];      
         for (unsigned i = 0; i < w.size(); ++i) {
@@ -744,6 +865,8 @@ namespace sat {
         if (m_out) dump(2, ls, status::deleted);
         if (m_bout) bdump(2, ls, status::deleted);
         if (m_check) append(l1, l2, status::deleted);
+        if (m_check && m_checkpoint > 0 && m_num_add + m_num_del >= m_next_checkpoint)
+            checkpoint();
     }
 
     void drat::del(clause& c) {
@@ -765,6 +888,8 @@ namespace sat {
             clause* c1 = m_alloc.mk_clause(c.size(), c.begin(), c.is_learned()); 
             append(*c1, status::deleted);
         }
+        if (m_check && m_checkpoint > 0 && m_num_add + m_num_del >= m_next_checkpoint)
+            checkpoint();
     }
 
     void drat::del(literal_vector const& c) {
@@ -775,6 +900,8 @@ namespace sat {
             clause* c1 = m_alloc.mk_clause(c.size(), c.begin(), true); 
             append(*c1, status::deleted);
         }
+        if (m_check && m_checkpoint > 0 && m_num_add + m_num_del >= m_next_checkpoint)
+            checkpoint();
     }
     
     void drat::check_model(model const& m) {        
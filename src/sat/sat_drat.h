@@ -19,6 +19,26 @@ Notes:
 #pragma once
 
 namespace sat {
+
+    /**
+       \brief buffered output of binary proof steps.
+       Steps are accumulated in a large buffer that is handed to the
+       operating system with a single write call when it is full.
+    */
+    class drat_buffer {
+        int      m_fd;
+        char*    m_buffer;
+        unsigned m_size;
+        unsigned m_capacity;
+    public:
+        drat_buffer(char const* file_name, unsigned capacity);
+        ~drat_buffer();
+        bool is_open() const { return m_fd >= 0; }
+        void put(unsigned char ch) { if (m_size == m_capacity) flush(); m_buffer[m_size++] = ch; }
+        void put_varint(unsigned v);
+        void flush();
+    };
+
     class drat {
     public:
         struct s_ext {};
@@ -46,7 +66,7 @@ namespace sat {
         solver& s;
         clause_allocator        m_alloc;
         std::ostream*           m_out;
-        std::ostream*           m_bout;
+        drat_buffer*            m_bout;
         ptr_vector<clause>      m_proof;
         svector<status>         m_status;        
         literal_vector          m_units;
@@ -55,6 +75,7 @@ namespace sat {
         bool                    m_inconsistent;
         unsigned                m_num_add, m_num_del;
         bool                    m_check_unsat, m_check_sat, m_check, m_activity;
+        unsigned                m_checkpoint, m_next_checkpoint;
 
         void dump_activity();
         void dump(unsigned n, literal const* c, status st);
@@ -62,6 +83,8 @@ namespace sat {
         void append(literal l, status st);
         void append(literal l1, literal l2, status st);
         void append(clause& c, status st);
+        void attach(clause& c);
+        void checkpoint();
 
         bool is_clause(clause& c, literal l1, literal l2, literal l3, status st1, status st2);
 
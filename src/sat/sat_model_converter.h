@@ -65,7 +65,7 @@ namespace sat {
             unsigned ref_count() const { return m_refcount; }
         };
 
-        enum kind { ELIM_VAR = 0, BCE, CCE, ACCE, ABCE, ATE };
+        enum kind { ELIM_VAR = 0, BCE, CCE, ACCE, ABCE, ATE, BVA };
         class entry {
             friend class model_converter;
             bool_var                m_var;
@@ -152,6 +152,7 @@ namespace sat {
         case model_converter::ACCE: out << "acce"; break;
         case model_converter::ABCE: out << "abce"; break;
         case model_converter::ATE: out << "ate"; break;
+        case model_converter::BVA: out << "bva"; break;
         }
         return out;
     }
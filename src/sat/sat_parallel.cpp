@@ -22,75 +22,160 @@ Revision History:
 
 namespace sat {
 
-    void parallel::vector_pool::next(unsigned& index) {
-        SASSERT(index < m_size);
-        unsigned n = index + 2 + get_length(index);
-        if (n >= m_size) {
-            index = 0;
-        }
-        else {
-            index = n;
-        }
+    parallel::clause_ring::clause_ring(unsigned sz): 
+        m_capacity(1), m_tail(0), m_reserved(0), m_seq(0) {
+        while (m_capacity < sz) m_capacity *= 2;
+        m_mask = m_capacity - 1;
+        m_data = alloc_vect<std::atomic<unsigned>>(m_capacity);
+        for (unsigned i = 0; i < m_capacity; ++i) 
+            m_data[i].store(0, std::memory_order_relaxed);
     }
 
-    void parallel::vector_pool::reserve(unsigned num_threads, unsigned sz) {
-        m_vectors.reset();
-        m_vectors.resize(sz, 0);
-        m_heads.reset();
-        m_heads.resize(num_threads, 0);
-        m_at_end.reset();
-        m_at_end.resize(num_threads, true);
-        m_tail = 0;
-        m_size = sz;
+    parallel::clause_ring::~clause_ring() {
+        dealloc_vect(m_data, m_capacity);
     }
-    
-    void parallel::vector_pool::begin_add_vector(unsigned owner, unsigned n) {
-        SASSERT(m_tail < m_size);
-        unsigned capacity = n + 2;
-        m_vectors.reserve(m_size + capacity, 0);
-        IF_VERBOSE(3, verbose_stream() << owner << ": begin-add " << n << " tail: " << m_tail << " size: " << m_size << "\n";);
-        for (unsigned i = 0; i < m_heads.size(); ++i) {
-            while (m_tail < m_heads[i] && m_heads[i] < m_tail + capacity) {
-                next(m_heads[i]);
+
+    bool parallel::clause_ring::push(unsigned n, unsigned const* elems) {
+        if (n + 2 > m_capacity) 
+            return false;
+        uint64_t pos = m_tail.load(std::memory_order_relaxed);
+        uint64_t end = pos + n + 2;
+        m_reserved.store(end, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_data[pos++ & m_mask].store(++m_seq, std::memory_order_relaxed);
+        m_data[pos++ & m_mask].store(n, std::memory_order_relaxed);
+        for (unsigned i = 0; i < n; ++i) 
+            m_data[pos++ & m_mask].store(elems[i], std::memory_order_relaxed);
+        m_tail.store(end, std::memory_order_release);
+        return true;
+    }
+
+    bool parallel::clause_ring::pop(uint64_t& pos, unsigned& last_seq, unsigned_vector& elems, unsigned& lost) {
+        uint64_t tail = m_tail.load(std::memory_order_acquire);
+        while (pos < tail) {
+            if (tail - pos > m_capacity) {
+                // overtaken by the producer
+                pos = tail;
+                return false;
             }
-            m_at_end[i] = false;
+            unsigned seq = get(pos);
+            unsigned n = get(pos + 1);
+            bool valid = n + 2 <= m_capacity;
+            elems.reset();
+            for (unsigned i = 0; valid && i < n; ++i) 
+                elems.push_back(get(pos + 2 + i));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (!valid || m_reserved.load(std::memory_order_relaxed) > pos + m_capacity) {
+                // the record was overwritten while it was read.
+                pos = m_tail.load(std::memory_order_acquire);
+                return false;
+            }
+            pos += n + 2;
+            lost += seq - last_seq - 1;
+            last_seq = seq;
+            return true;
+        }
+        return false;
+    }
+
+    parallel::elite_pool::elite_pool(unsigned num_slots, unsigned num_vars):
+        m_num_slots(num_slots),
+        m_num_words((num_vars + 63) / 64) {
+        m_version = alloc_vect<std::atomic<unsigned>>(m_num_slots);
+        m_cost    = alloc_vect<std::atomic<unsigned>>(m_num_slots);
+        m_bits    = alloc_vect<std::atomic<uint64_t>>(m_num_slots * m_num_words);
+        for (unsigned i = 0; i < m_num_slots; ++i) {
+            m_version[i].store(0, std::memory_order_relaxed);
+            m_cost[i].store(UINT_MAX, std::memory_order_relaxed);
         }
-        m_vectors[m_tail++] = owner;
-        m_vectors[m_tail++] = n;    
+        for (unsigned i = 0; i < m_num_slots * m_num_words; ++i)
+            m_bits[i].store(0, std::memory_order_relaxed);
+    }
+
+    parallel::elite_pool::~elite_pool() {
+        dealloc_vect(m_version, m_num_slots);
+        dealloc_vect(m_cost, m_num_slots);
+        dealloc_vect(m_bits, m_num_slots * m_num_words);
     }
 
-    void parallel::vector_pool::add_vector_elem(unsigned e) {
-        m_vectors[m_tail++] = e;
+    bool parallel::elite_pool::publish(unsigned cost, bool_vector const& values) {
+        unsigned worst = 0;
+        for (unsigned i = 0; i < m_num_slots; ++i) {
+            unsigned c = m_cost[i].load(std::memory_order_relaxed);
+            if (c == cost)
+                return false;
+            if (c > m_cost[worst].load(std::memory_order_relaxed))
+                worst = i;
+        }
+        unsigned version = m_version[worst].load(std::memory_order_relaxed);
+        if ((version & 1) != 0 || cost >= m_cost[worst].load(std::memory_order_relaxed))
+            return false;
+        if (!m_version[worst].compare_exchange_strong(version, version + 1, std::memory_order_acquire))
+            return false;
+        // readers that see the stores below also see the odd version.
+        std::atomic_thread_fence(std::memory_order_release);
+        std::atomic<uint64_t>* bits = m_bits + worst * m_num_words;
+        unsigned num_vars = std::min(values.size(), 64 * m_num_words);
+        for (unsigned w = 0; w < m_num_words; ++w) {
+            uint64_t word = 0;
+            for (unsigned v = 64 * w, end = std::min(num_vars, 64 * w + 64); v < end; ++v)
+                if (values[v]) word |= (1ull << (v - 64 * w));
+            bits[w].store(word, std::memory_order_relaxed);
+        }
+        m_cost[worst].store(cost, std::memory_order_relaxed);
+        m_version[worst].store(version + 2, std::memory_order_release);
+        return true;
     }
 
-    void parallel::vector_pool::end_add_vector() {
-        if (m_tail >= m_size) {
-            m_tail = 0;
+    bool parallel::elite_pool::get(unsigned slot, unsigned& cost, bool_vector& values) const {
+        unsigned version = m_version[slot].load(std::memory_order_acquire);
+        if ((version & 1) != 0)
+            return false;
+        cost = m_cost[slot].load(std::memory_order_relaxed);
+        if (cost == UINT_MAX)
+            return false;
+        std::atomic<uint64_t> const* bits = m_bits + slot * m_num_words;
+        values.reset();
+        for (unsigned w = 0; w < m_num_words; ++w) {
+            uint64_t word = bits[w].load(std::memory_order_relaxed);
+            for (unsigned i = 0; i < 64; ++i)
+                values.push_back((word & (1ull << i)) != 0);
         }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return version == m_version[slot].load(std::memory_order_relaxed);
     }
 
+    void parallel::init_elite_pool(unsigned num_slots, unsigned num_vars) {
+        m_elite = num_slots > 0 ? alloc(elite_pool, num_slots, num_vars) : nullptr;
+    }
 
-    bool parallel::vector_pool::get_vector(unsigned owner, unsigned& n, unsigned const*& ptr) {
-        unsigned head = m_heads[owner];      
-        unsigned iterations = 0;
-        while (head != m_tail || !m_at_end[owner]) {
-            ++iterations;
-            SASSERT(head < m_size && m_tail < m_size);            
-            bool is_self = owner == get_owner(head);
-            next(m_heads[owner]);
-            IF_VERBOSE(static_cast<unsigned>(iterations > m_size ? 0 : 3), verbose_stream() << owner << ": [" << head << ":" << m_heads[owner] << "] tail: " << m_tail << "\n";);
-            m_at_end[owner] = (m_heads[owner] == m_tail);
-            if (!is_self) {
-                n = get_length(head);
-                ptr = get_ptr(head);
-                return true;
-            }
-            head = m_heads[owner];
+    bool parallel::publish_elite(unsigned cost, bool_vector const& values) {
+        if (!m_elite || !m_elite->publish(cost, values))
+            return false;
+        ++m_elite_published;
+        return true;
+    }
+
+    bool parallel::get_elite(random_gen& rand, unsigned& cost, bool_vector& values) {
+        if (!m_elite || !m_elite->get(rand(m_elite->num_slots()), cost, values))
+            return false;
+        ++m_elite_imported;
+        return true;
+    }
+
+    void parallel::reserve(unsigned num_owners, unsigned sz) {
+        m_rings.reset();
+        m_consumers.reset();
+        for (unsigned i = 0; i < num_owners; ++i) {
+            m_rings.push_back(alloc(clause_ring, sz));
+            consumer* c = alloc(consumer);
+            c->m_pos.resize(num_owners, 0);
+            c->m_last_seq.resize(num_owners, 0);
+            m_consumers.push_back(c);
         }
-        return false;
     }
 
-    parallel::parallel(solver& s): m_num_clauses(0), m_consumer_ready(false), m_scoped_rlimit(s.rlimit()) {}
+    parallel::parallel(solver& s): m_elite_published(0), m_elite_imported(0), m_num_clauses(0), m_consumer_ready(false), m_scoped_rlimit(s.rlimit()) {}
 
     parallel::~parallel() {
         for (unsigned i = 0; i < m_solvers.size(); ++i) {            
@@ -125,83 +210,90 @@ namespace sat {
     }
 
 
-    void parallel::exchange(solver& s, literal_vector const& in, unsigned& limit, literal_vector& out) {
+    void parallel::exchange(solver& s, literal_vector const& in, literal_vector& out) {
         if (s.get_config().m_num_threads == 1 || s.m_par_syncing_clauses) return;
         flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
-        {
-            lock_guard lock(m_mux);
-            if (limit < m_units.size()) {
-                // this might repeat some literals.
-                out.append(m_units.size() - limit, m_units.c_ptr() + limit);
-            }
-            for (unsigned i = 0; i < in.size(); ++i) {
-                literal lit = in[i];
-                if (!m_unit_set.contains(lit.index())) {
-                    m_unit_set.insert(lit.index());
-                    m_units.push_back(lit);
-                }
-            }
-            limit = m_units.size();
+        for (literal lit : in) {
+            unsigned idx = lit.index();
+            push(s, 1, &idx);
         }
+        consumer& c = *m_consumers[s.m_par_id];
+        out.append(c.m_units);
+        c.m_units.reset();
+    }
+
+    void parallel::push(solver& s, unsigned n, unsigned const* elems) {
+        stats& st = m_consumers[s.m_par_id]->m_stats;
+        if (m_rings[s.m_par_id]->push(n, elems)) 
+            st.m_exported++;
+        else 
+            st.m_dropped++;
     }
 
     void parallel::share_clause(solver& s, literal l1, literal l2) {        
         if (s.get_config().m_num_threads == 1 || s.m_par_syncing_clauses) return;
         flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
         IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": share " <<  l1 << " " << l2 << "\n";);
-        {
-            lock_guard lock(m_mux);
-            m_pool.begin_add_vector(s.m_par_id, 2);
-            m_pool.add_vector_elem(l1.index());
-            m_pool.add_vector_elem(l2.index());            
-            m_pool.end_add_vector();
-        }        
+        unsigned elems[2] = { l1.index(), l2.index() };
+        push(s, 2, elems);
     }
 
     void parallel::share_clause(solver& s, clause const& c) {        
-        if (s.get_config().m_num_threads == 1 || !enable_add(c) || s.m_par_syncing_clauses) return;
-        flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
-        unsigned n = c.size();
-        unsigned owner = s.m_par_id;
-        IF_VERBOSE(3, verbose_stream() << owner << ": share " <<  c << "\n";);
-        lock_guard lock(m_mux);
-        m_pool.begin_add_vector(owner, n);                
-        for (unsigned i = 0; i < n; ++i) {
-            m_pool.add_vector_elem(c[i].index());
+        if (s.get_config().m_num_threads == 1 || s.m_par_syncing_clauses) return;
+        if (!enable_add(s, c)) {
+            m_consumers[s.m_par_id]->m_stats.m_dropped++;
+            return;
         }
-        m_pool.end_add_vector();        
+        flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
+        IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": share " <<  c << "\n";);
+        unsigned_vector& elems = m_consumers[s.m_par_id]->m_elems;
+        elems.reset();
+        for (literal l : c) 
+            elems.push_back(l.index());
+        push(s, elems.size(), elems.c_ptr());
     }
 
     void parallel::get_clauses(solver& s) {
         if (s.m_par_syncing_clauses) return;
         flet<bool> _disable_sync_clause(s.m_par_syncing_clauses, true);
-        lock_guard lock(m_mux);
         _get_clauses(s);        
     }
 
     void parallel::_get_clauses(solver& s) {
-        unsigned n;
-        unsigned const* ptr;
         unsigned owner = s.m_par_id;
-        while (m_pool.get_vector(owner, n, ptr)) {
-            m_lits.reset();
-            bool usable_clause = true;
-            for (unsigned i = 0; usable_clause && i < n; ++i) {
-                literal lit(to_literal(ptr[i]));                
-                m_lits.push_back(lit);
-                usable_clause = lit.var() <= s.m_par_num_vars && !s.was_eliminated(lit.var());
-            }
-            IF_VERBOSE(3, verbose_stream() << s.m_par_id << ": retrieve " << m_lits << "\n";);
-            SASSERT(n >= 2);
-            if (usable_clause) {
-                s.mk_clause_core(m_lits.size(), m_lits.c_ptr(), true);
+        consumer& c = *m_consumers[owner];
+        literal_vector lits;
+        for (unsigned i = 0; i < m_rings.size(); ++i) {
+            if (i == owner) 
+                continue;
+            while (m_rings[i]->pop(c.m_pos[i], c.m_last_seq[i], c.m_elems, c.m_stats.m_dropped)) {
+                lits.reset();
+                bool usable_clause = true;
+                for (unsigned j = 0; usable_clause && j < c.m_elems.size(); ++j) {
+                    literal lit(to_literal(c.m_elems[j]));
+                    lits.push_back(lit);
+                    usable_clause = lit.var() <= s.m_par_num_vars && !s.was_eliminated(lit.var());
+                }
+                IF_VERBOSE(3, verbose_stream() << owner << ": retrieve " << lits << "\n";);
+                if (!usable_clause) {
+                    c.m_stats.m_dropped++;
+                }
+                else if (lits.size() == 1) {
+                    c.m_units.push_back(lits[0]);
+                    c.m_stats.m_imported++;
+                }
+                else {
+                    s.mk_clause_core(lits.size(), lits.c_ptr(), true);
+                    c.m_stats.m_imported++;
+                }
             }
-        }        
+        }
     }
 
-    bool parallel::enable_add(clause const& c) const {
+    bool parallel::enable_add(solver const& s, clause const& c) const {
         // plingeling, glucose heuristic:
-        return (c.size() <= 40 && c.glue() <= 8) || c.glue() <= 2;
+        config const& cfg = s.get_config();
+        return (c.size() <= cfg.m_par_max_size && c.glue() <= cfg.m_par_max_glue) || c.glue() <= 2;
     }
 
     void parallel::_from_solver(solver& s) {
@@ -277,5 +369,33 @@ namespace sat {
         return copied;
     }
     
-};
+    void parallel::collect_statistics(statistics& st) const {
+        stats total;
+        for (consumer* c : m_consumers) {
+            total.m_exported += c->m_stats.m_exported;
+            total.m_imported += c->m_stats.m_imported;
+            total.m_dropped  += c->m_stats.m_dropped;
+        }
+        st.update("sat par exported", total.m_exported);
+        st.update("sat par imported", total.m_imported);
+        st.update("sat par dropped", total.m_dropped);
+        if (m_elite) {
+            st.update("sat par elite published", m_elite_published.load());
+            st.update("sat par elite imported", m_elite_imported.load());
+        }
+    }
 
+    std::ostream& parallel::display_stats(std::ostream& out) const {
+        for (unsigned i = 0; i < m_consumers.size(); ++i) {
+            stats const& st = m_consumers[i]->m_stats;
+            if (st.m_exported + st.m_imported + st.m_dropped == 0) 
+                continue;
+            out << "(sat-parallel :thread " << i 
+                << " :exported " << st.m_exported 
+                << " :imported " << st.m_imported 
+                << " :dropped " << st.m_dropped << ")\n";
+        }
+        return out;
+    }
+
+};
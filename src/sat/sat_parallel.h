@@ -24,44 +24,91 @@ Revision History:
 #include "util/rlimit.h"
 #include "util/scoped_ptr_vector.h"
 #include "util/mutex.h"
+#include "util/statistics.h"
+#include <atomic>
 
 namespace sat {
 
     class parallel {
 
-        // shared pool of learned clauses.
-        class vector_pool {
-            unsigned_vector m_vectors;
-            unsigned        m_size;
-            unsigned        m_tail;
-            unsigned_vector m_heads;
-            bool_vector   m_at_end;
-            void next(unsigned& index);
-            unsigned get_owner(unsigned index) const { return m_vectors[index]; }
-            unsigned get_length(unsigned index) const { return m_vectors[index+1]; }
-            unsigned const* get_ptr(unsigned index) const { return m_vectors.c_ptr() + index + 2; }
+        /**
+           \brief lock-free ring of learned clauses written by a single producer.
+
+           Records are laid out as [seq, n, lit_1, ..., lit_n].
+           The producer announces the end of the record it is about to write in m_reserved,
+           writes the record and publishes it by advancing m_tail.
+           Consumers keep their own read positions. A consumer that is overtaken by the
+           producer re-synchronizes at the tail and accounts for the lost records using the 
+           sequence numbers.
+        */
+        class clause_ring {
+            std::atomic<unsigned>* m_data;
+            unsigned               m_capacity;
+            unsigned               m_mask;
+            std::atomic<uint64_t>  m_tail;
+            std::atomic<uint64_t>  m_reserved;
+            unsigned               m_seq;
+            unsigned get(uint64_t pos) const { return m_data[pos & m_mask].load(std::memory_order_relaxed); }
         public:
-            vector_pool() {}
-            void reserve(unsigned num_owners, unsigned sz);
-            void begin_add_vector(unsigned owner, unsigned n);
-            void end_add_vector();
-            void add_vector_elem(unsigned e);
-            bool get_vector(unsigned owner, unsigned& n, unsigned const*& ptr);
+            clause_ring(unsigned sz);
+            ~clause_ring();
+            bool push(unsigned n, unsigned const* elems);
+            bool pop(uint64_t& pos, unsigned& last_seq, unsigned_vector& elems, unsigned& lost);
         };
 
-        bool enable_add(clause const& c) const;
+        /**
+           \brief lock-free pool of the best assignments found by local search threads.
+
+           Each slot holds the number of falsified clauses of an assignment and the
+           assignment packed into 64-bit words. A writer owns a slot while its version is odd
+           and only replaces a slot with a worse assignment. Readers copy a slot optimistically 
+           and discard the copy if the version changed while it was read.
+        */
+        class elite_pool {
+            unsigned                m_num_slots;
+            unsigned                m_num_words;
+            std::atomic<unsigned>*  m_version;
+            std::atomic<unsigned>*  m_cost;
+            std::atomic<uint64_t>*  m_bits;
+        public:
+            elite_pool(unsigned num_slots, unsigned num_vars);
+            ~elite_pool();
+            unsigned num_slots() const { return m_num_slots; }
+            bool publish(unsigned cost, bool_vector const& values);
+            bool get(unsigned slot, unsigned& cost, bool_vector& values) const;
+        };
+
+        struct stats {
+            unsigned m_exported;
+            unsigned m_imported;
+            unsigned m_dropped;
+            stats() { reset(); }
+            void reset() { m_exported = m_imported = m_dropped = 0; }
+        };
+
+        // per thread state, only accessed by the owning thread.
+        struct consumer {
+            svector<uint64_t> m_pos;      // read position in each ring
+            unsigned_vector   m_last_seq; // last sequence number read from each ring
+            unsigned_vector   m_elems;
+            literal_vector    m_units;    // units received since last exchange
+            stats             m_stats;
+        };
+
+        bool enable_add(solver const& s, clause const& c) const;
+        void push(solver& s, unsigned n, unsigned const* elems);
         void _get_clauses(solver& s);
         void _from_solver(solver& s);
         bool _to_solver(solver& s);
         bool _from_solver(i_local_search& s);
         void _to_solver(i_local_search& s);
 
-        typedef hashtable<unsigned, u_hash, u_eq> index_set;
-        literal_vector m_units;
-        index_set      m_unit_set;
-        literal_vector m_lits;
-        vector_pool    m_pool;
-        mutex          m_mux;
+        scoped_ptr<elite_pool>          m_elite;
+        std::atomic<unsigned>           m_elite_published;
+        std::atomic<unsigned>           m_elite_imported;
+        scoped_ptr_vector<clause_ring>  m_rings;
+        scoped_ptr_vector<consumer>     m_consumers;
+        mutex                           m_mux;      // protects exchange with local search
 
         // for exchange with local search:
         unsigned           m_num_clauses;
@@ -83,15 +130,15 @@ namespace sat {
 
         void push_child(reslimit& rl);
 
-        // reserve space
-        void reserve(unsigned num_owners, unsigned sz) { m_pool.reserve(num_owners, sz); }
+        // reserve a ring of sz elements for each owner
+        void reserve(unsigned num_owners, unsigned sz);
 
         solver& get_solver(unsigned i) { return *m_solvers[i]; }
 
         void cancel_solver(unsigned i) { m_limits[i].cancel(); }
 
         // exchange unit literals
-        void exchange(solver& s, literal_vector const& in, unsigned& limit, literal_vector& out);
+        void exchange(solver& s, literal_vector const& in, literal_vector& out);
 
         // add clause to shared clause pool
         void share_clause(solver& s, clause const& c);
@@ -109,6 +156,15 @@ namespace sat {
         void to_solver(i_local_search& s);
         
         bool copy_solver(solver& s);
+
+        // exchange of best assignments between local search threads.
+        void init_elite_pool(unsigned num_slots, unsigned num_vars);
+        bool publish_elite(unsigned cost, bool_vector const& values);
+        bool get_elite(random_gen& rand, unsigned& cost, bool_vector& values);
+
+        void collect_statistics(statistics& st) const;
+
+        std::ostream& display_stats(std::ostream& out) const;
     };
 
 };
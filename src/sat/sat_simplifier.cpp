@@ -62,7 +62,8 @@ namespace sat {
 
     simplifier::simplifier(solver & _s, params_ref const & p):
         s(_s),
-        m_num_calls(0) {
+        m_num_calls(0),
+        m_bva_simplifier(*this) {
         updt_params(p);
         reset_statistics();
     }
@@ -112,6 +113,11 @@ namespace sat {
     bool simplifier::elim_vars_enabled() const { 
         return !m_incremental_mode && !s.tracking_assumptions() && m_elim_vars && single_threaded(); 
     }    
+    bool simplifier::bva_enabled() const {
+        return 
+            !m_incremental_mode && !s.tracking_assumptions() && m_bva && single_threaded() &&
+            !s.m_ext && !s.m_config.m_drat && s.m_user_scope_literals.empty();
+    }
 
     void simplifier::register_clauses(clause_vector & cs) {
         std::stable_sort(cs.begin(), cs.end(), size_lt());
@@ -187,8 +193,12 @@ namespace sat {
 
         if (s.inconsistent())
             return;
-        if (!m_subsumption && !bce_enabled() && !bca_enabled() && !elim_vars_enabled())
+        if (!m_subsumption && !bce_enabled() && !bca_enabled() && !elim_vars_enabled() && !bva_enabled())
             return;
+
+        // fresh variables are created before the use lists are sized
+        if (!learned && bva_enabled())
+            m_bva_simplifier(m_bva_limit);
        
         initialize();
 
@@ -2097,6 +2107,8 @@ namespace sat {
         m_elim_vars               = p.elim_vars();
         m_elim_vars_bdd           = false && p.elim_vars_bdd(); // buggy?
         m_elim_vars_bdd_delay     = p.elim_vars_bdd_delay();
+        m_bva                     = p.bva();
+        m_bva_limit               = p.bva_limit();
         m_incremental_mode        = s.get_config().m_incremental && !p.override_incremental();
     }
 
@@ -2114,6 +2126,7 @@ namespace sat {
         st.update("sat abce", m_num_abce);
         st.update("sat bca",  m_num_bca);
         st.update("sat ate",  m_num_ate);
+        m_bva_simplifier.collect_statistics(st);
     }
 
     void simplifier::reset_statistics() {
@@ -2127,5 +2140,6 @@ namespace sat {
         m_num_elim_vars = 0;
         m_num_bca = 0;
         m_num_ate = 0;
+        m_bva_simplifier.reset_statistics();
     }
 };
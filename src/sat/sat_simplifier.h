@@ -27,6 +27,7 @@ Revision History:
 #include "sat/sat_extension.h"
 #include "sat/sat_watched.h"
 #include "sat/sat_model_converter.h"
+#include "sat/sat_bva.h"
 #include "util/heap.h"
 #include "util/statistics.h"
 #include "util/params.h"
@@ -52,6 +53,7 @@ namespace sat {
     class simplifier {
         friend class ba_solver;
         friend class elim_vars;
+        friend class bva;
         solver &               s;
         unsigned               m_num_calls;
         use_list               m_use_list;
@@ -99,6 +101,8 @@ namespace sat {
         bool                   m_elim_vars;
         bool                   m_elim_vars_bdd;
         unsigned               m_elim_vars_bdd_delay;
+        bool                   m_bva;
+        unsigned               m_bva_limit;
 
         // stats
         unsigned               m_num_bce;
@@ -115,6 +119,8 @@ namespace sat {
         bool                   m_learned_in_use_lists;
         unsigned               m_old_num_elim_vars;
 
+        bva                    m_bva_simplifier;
+
         struct size_lt {
             bool operator()(clause const * c1, clause const * c2) const { return c1->size() > c2->size(); }
         };
@@ -184,6 +190,7 @@ namespace sat {
         bool bca_enabled()  const;
         bool elim_vars_bdd_enabled() const;
         bool elim_vars_enabled() const;
+        bool bva_enabled() const;
 
         unsigned num_nonlearned_bin(literal l) const;
         unsigned get_to_elim_cost(bool_var v) const;
@@ -56,6 +56,7 @@ namespace sat {
         m_probing(*this, p),
         m_mus(*this),
         m_binspr(*this),
+        m_vivify(*this, p),
         m_inconsistent(false),
         m_searching(false),
         m_conflict(justification(0)),
@@ -622,6 +623,7 @@ namespace sat {
         pop(scope_lvl());
         IF_VERBOSE(2, verbose_stream() << "(sat-defrag)\n");
         clause_allocator& alloc = m_cls_allocator[!m_cls_allocator_idx];
+        m_arena_order.reset();
         ptr_vector<clause> new_clauses, new_learned;
         for (clause* c : m_clauses) c->unmark_used();
         for (clause* c : m_learned) c->unmark_used();
@@ -650,7 +652,7 @@ namespace sat {
                         else {
                             new_clauses.push_back(c2);
                         }
-                        offset = get_offset(*c2);
+                        offset = alloc.get_offset(c2);
                         c1.set_new_offset(offset);
                     }
                     w = watched(w.get_blocked_literal(), offset);
@@ -683,6 +685,29 @@ namespace sat {
         reinit_assumptions();
     }
 
+    /**
+       \brief relocate short learned clauses such that clauses used for propagation 
+       since the last gc round are laid out consecutively in the order they were used.
+       Watch lists and justifications refer to clauses by offset and are unaffected,
+       only the clause pointers owned by the solver are refreshed.
+    */
+    void solver::reorder_small_arena() {
+        if (m_arena_order.empty())
+            return;
+        clause_allocator& alloc = cls_allocator();
+        alloc.reorder_small_arena(m_arena_order);
+        m_arena_order.reset();
+        for (clause*& c : m_clauses) 
+            if (c->in_small_arena()) c = alloc.get_clause(c->id());
+        for (clause*& c : m_learned) 
+            if (c->in_small_arena()) c = alloc.get_clause(c->id());
+        for (clause_wrapper& cw : m_clauses_to_reinit) 
+            if (!cw.is_binary() && cw.get_clause()->in_small_arena()) 
+                cw = clause_wrapper(*alloc.get_clause(cw.get_clause()->id()));
+        alloc.release_small_arena();
+        m_stats.m_arena_reorder++;
+    }
+
 
     void solver::set_learned(literal l1, literal l2, bool learned) {
         set_learned1(l1, l2, learned);
@@ -1049,7 +1074,9 @@ namespace sat {
 
                     if (value(c[0]) == l_false) {
                         assign_level = std::max(assign_level, lvl(c[0]));
+                        if (c.is_learned()) m_stats.m_tier_conflicts[c.tier()]++;
                         c.mark_used();
+                        mark_arena_use(c, cls_off);
                         CONFLICT_CLEANUP();
                         set_conflict(justification(assign_level, cls_off));
                         return false;
@@ -1066,8 +1093,9 @@ namespace sat {
                         }
                         m_stats.m_propagate++;
                         c.mark_used();
+                        mark_arena_use(c, cls_off);
                         assign_core(c[0], justification(assign_level, cls_off));
-                        if (update && c.is_learned() && c.glue() > 2) {
+                        if (update && c.is_learned() && c.tier() != TIER_CORE && c.glue() > 2) {
                             unsigned glue;
                             if (num_diff_levels_below(c.size(), c.begin(), c.glue()-1, glue)) {
                                 c.set_glue(glue);
@@ -1368,8 +1396,10 @@ namespace sat {
 #define IS_MAIN_SOLVER(i)  (i == main_solver_offset)
 
         sat::parallel par(*this);
-        par.reserve(num_threads, 1 << 12);
+        par.reserve(num_threads, 1 << 14);
         par.init_solvers(*this, num_extra_solvers);
+        if (num_ddfw > 1)
+            par.init_elite_pool(m_config.m_ddfw_elite_pool, num_vars());
         for (unsigned i = 0; i < ls.size(); ++i) {
             par.push_child(ls[i]->rlimit());
         }
@@ -1454,6 +1484,8 @@ namespace sat {
         if (IS_AUX_SOLVER(finished_id)) {
             m_stats = par.get_solver(finished_id).m_stats;
         }
+        par.collect_statistics(m_aux_stats);
+        IF_VERBOSE(1, par.display_stats(verbose_stream()));
         if (result == l_true && IS_AUX_SOLVER(finished_id)) {
             set_model(par.get_solver(finished_id).get_model(), true);
         }
@@ -1500,7 +1532,7 @@ namespace sat {
                 }
             }
             m_par_limit_out = sz;
-            m_par->exchange(*this, out, m_par_limit_in, in);
+            m_par->exchange(*this, out, in);
             for (unsigned i = 0; !inconsistent() && i < in.size(); ++i) {
                 literal lit = in[i];
                 SASSERT(lit.var() < m_par_num_vars);
@@ -1518,7 +1550,6 @@ namespace sat {
     void solver::set_par(parallel* p, unsigned id) {
         m_par = p;
         m_par_num_vars = num_vars();
-        m_par_limit_in = 0;
         m_par_limit_out = 0;
         m_par_id = id; 
         m_par_syncing_clauses = false;
@@ -1893,6 +1924,11 @@ namespace sat {
         CASSERT("sat_simplify_bug", check_invariant());
         m_asymm_branch(false);
 
+        CASSERT("sat_missed_prop", check_missed_propagation());
+        CASSERT("sat_simplify_bug", check_invariant());
+
+        m_vivify();
+
         CASSERT("sat_missed_prop", check_missed_propagation());
         CASSERT("sat_simplify_bug", check_invariant());
         if (m_ext) {
@@ -2177,39 +2213,36 @@ namespace sat {
             }
             log_stats();
         }
-        TRACE("sat", tout << "restart " << restart_level(to_base) << "\n";);
         IF_VERBOSE(30, display_status(verbose_stream()););
-        TRACE("sat", tout << "restart " << restart_level(to_base) << "\n";);
-        pop_reinit(restart_level(to_base));
+        unsigned num_scopes = restart_level(to_base);
+        TRACE("sat", tout << "restart " << num_scopes << "\n";);
+        m_stats.m_restart_reused += scope_lvl() - search_lvl() - num_scopes;
+        pop_reinit(num_scopes);
         set_next_restart();
     }
 
+    /**
+       \brief Return the number of scopes to pop on a restart.
+       Fast restarts reuse the trail (van der Tak, Ramos, Heule, 2011):
+       decision levels whose decision variable is more active than the 
+       next decision variable would be re-assigned in the same order
+       after a full restart, so they are kept.
+    */
     unsigned solver::restart_level(bool to_base) {
         if (to_base || scope_lvl() == search_lvl()) {
             return scope_lvl() - search_lvl();
         }
-        else {
-            bool_var next = m_case_split_queue.min_var();
-
-            // Implementations of Marijn's idea of reusing the 
-            // trail when the next decision literal has lower precedence.
-            // pop trail from top
-#if 0
-            unsigned n = 0;
-            do {
-                bool_var prev = scope_literal(scope_lvl() - n - 1).var();
-                if (m_case_split_queue.more_active(prev, next)) break;                
-                ++n;
-            }
-            while (n < scope_lvl() - search_lvl());
-            return n;
-#endif
-            // pop trail from bottom
-            unsigned n = search_lvl();
-            for (; n < scope_lvl() && m_case_split_queue.more_active(scope_literal(n).var(), next); ++n) {
-            }
-            return n - search_lvl();
+        while (!m_case_split_queue.empty() && value(m_case_split_queue.min_var()) != l_undef) {
+            m_case_split_queue.next_var();
         }
+        if (m_case_split_queue.empty()) {
+            return scope_lvl() - search_lvl();
+        }
+        bool_var next = m_case_split_queue.min_var();
+        unsigned n = search_lvl();
+        for (; n < scope_lvl() && m_case_split_queue.more_active(scope_literal(n).var(), next); ++n) {
+        }
+        return scope_lvl() - n;
     }
 
     void solver::update_activity(bool_var v, double p) {
@@ -2281,6 +2314,9 @@ namespace sat {
                 return;
             gc_dyn_psm();
             break;
+        case GC_TIERED:
+            gc_tiered();
+            break;
         default:
             UNREACHABLE();
             break;
@@ -2289,6 +2325,10 @@ namespace sat {
         if (gc > 0 && should_defrag()) {
             defrag_clauses();
         }
+        else if (m_config.m_gc_small_arena) {
+            // relocation copies the arena, so it is amortized over gc rounds rather than restarts.
+            reorder_small_arena();
+        }
         CASSERT("sat_gc_bug", check_invariant());
     }
 
@@ -2519,6 +2559,87 @@ namespace sat {
                    " :frozen " << frozen << " :activated " << activated << " :deleted " << deleted << ")\n";);
     }
 
+    clause_tier solver::glue2tier(unsigned glue) const {
+        if (glue <= m_config.m_gc_tier1_glue) return TIER_CORE;
+        if (glue <= m_config.m_gc_tier2_glue) return TIER_2;
+        return TIER_LOCAL;
+    }
+
+    /**
+       \brief Lex on (used, glue, size) for clauses in the local tier.
+    */
+    struct local_tier_lt {
+        bool operator()(clause const * c1, clause const * c2) const {
+            if (c1->was_used() != c2->was_used()) return c1->was_used();
+            if (c1->glue() < c2->glue()) return true;
+            if (c1->glue() > c2->glue()) return false;
+            return c1->size() < c2->size();
+        }
+    };
+
+    /**
+       \brief Use gc based on a three tiered clause database.
+       - core clauses have small glue and are never deleted.
+       - tier2 clauses are demoted to the local tier when they have not 
+         been used in propagation or conflicts for m_gc_tier2_rounds gc rounds.
+       - the less active half of the local tier is deleted.
+       Clauses whose glue was reduced during propagation are promoted.
+    */
+    void solver::gc_tiered() {
+        TRACE("sat", tout << "gc\n";);
+        unsigned promoted = 0, demoted = 0;
+        for (clause* cp : m_learned) {
+            clause& c = *cp;
+            clause_tier t = glue2tier(c.glue());
+            if (t < c.tier()) {
+                c.set_tier(t);
+                c.reset_inact_rounds();
+                promoted++;
+            }
+            if (c.tier() != TIER_2)
+                continue;
+            if (c.was_used()) {
+                c.reset_inact_rounds();
+            }
+            else {
+                c.inc_inact_rounds();
+                if (c.inact_rounds() > m_config.m_gc_tier2_rounds) {
+                    c.set_tier(TIER_LOCAL);
+                    c.reset_inact_rounds();
+                    demoted++;
+                }
+            }
+            c.unmark_used();
+        }
+        clause** local = std::stable_partition(m_learned.begin(), m_learned.end(), 
+                                               [](clause* c) { return c->tier() != TIER_LOCAL || c->frozen(); });
+        std::stable_sort(local, m_learned.end(), local_tier_lt());
+        unsigned sz     = m_learned.size();
+        unsigned new_sz = static_cast<unsigned>(local - m_learned.begin());
+        new_sz += (sz - new_sz) / 2;
+        unsigned j = new_sz;
+        for (unsigned i = 0; i < new_sz; i++) {
+            if (m_learned[i]->tier() == TIER_LOCAL)
+                m_learned[i]->unmark_used();
+        }
+        for (unsigned i = new_sz; i < sz; i++) {
+            clause & c = *(m_learned[i]);
+            if (can_delete(c)) {
+                detach_clause(c);
+                del_clause(c);
+            }
+            else {
+                c.unmark_used();
+                m_learned[j] = &c;
+                j++;
+            }
+        }
+        m_stats.m_gc_clause += sz - j;
+        m_learned.shrink(j);
+        IF_VERBOSE(SAT_VB_LVL, verbose_stream() << "(sat-gc :strategy tiered :promoted " << promoted 
+                   << " :demoted " << demoted << " :deleted " << (sz - j) << ")\n";);
+    }
+
     // return true if should keep the clause, and false if we should delete it.
     bool solver::activate_frozen_clause(clause & c) {
         TRACE("sat_gc", tout << "reactivating:\n" << c << "\n";);
@@ -2796,6 +2917,7 @@ namespace sat {
         clause * lemma = mk_clause_core(m_lemma.size(), m_lemma.c_ptr(), true);
         if (lemma) {
             lemma->set_glue(glue);
+            lemma->set_tier(glue2tier(glue));
         }
         if (m_par && lemma) {
             m_par->share_clause(*this, *lemma);
@@ -3911,11 +4033,14 @@ namespace sat {
         m_config.updt_params(p);
         m_simplifier.updt_params(p);
         m_asymm_branch.updt_params(p);
+        m_vivify.updt_params(p);
         m_probing.updt_params(p);
         m_scc.updt_params(p);
         m_rand.set_seed(m_config.m_random_seed);
         m_step_size = m_config.m_step_size_init;
         m_drat.updt_config();
+        m_cls_allocator[0].set_small_arena(m_config.m_gc_small_arena);
+        m_cls_allocator[1].set_small_arena(m_config.m_gc_small_arena);
         m_fast_glue_avg.set_alpha(m_config.m_fast_glue_avg);
         m_slow_glue_avg.set_alpha(m_config.m_slow_glue_avg);
         m_fast_glue_backup.set_alpha(m_config.m_fast_glue_avg);
@@ -3931,6 +4056,7 @@ namespace sat {
         config::collect_param_descrs(d);
         simplifier::collect_param_descrs(d);
         asymm_branch::collect_param_descrs(d);
+        vivify::collect_param_descrs(d);
         probing::collect_param_descrs(d);
         scc::collect_param_descrs(d);
     }
@@ -3941,18 +4067,47 @@ namespace sat {
         m_simplifier.collect_statistics(st);
         m_scc.collect_statistics(st);
         m_asymm_branch.collect_statistics(st);
+        m_vivify.collect_statistics(st);
         m_probing.collect_statistics(st);
         if (m_ext) m_ext->collect_statistics(st);
         if (m_local_search) m_local_search->collect_statistics(st);
         if (m_cut_simplifier) m_cut_simplifier->collect_statistics(st);
+        if (m_config.m_gc_strategy == GC_TIERED)
+            collect_tier_statistics(st);
         st.copy(m_aux_stats);
     }
 
+    void solver::collect_tier_statistics(statistics & st) const {
+        unsigned num_clauses[3] = { 0, 0, 0 };
+        size_t   bytes[3] = { 0, 0, 0 };
+        for (clause* c : m_learned) {
+            num_clauses[c->tier()]++;
+            bytes[c->tier()] += c->bytes();
+        }
+        double secs = m_stopwatch.get_current_seconds();
+        double mb = 1024.0 * 1024.0;
+        st.update("sat tier core clauses", num_clauses[TIER_CORE]);
+        st.update("sat tier 2 clauses", num_clauses[TIER_2]);
+        st.update("sat tier local clauses", num_clauses[TIER_LOCAL]);
+        st.update("sat tier core conflicts", m_stats.m_tier_conflicts[TIER_CORE]);
+        st.update("sat tier 2 conflicts", m_stats.m_tier_conflicts[TIER_2]);
+        st.update("sat tier local conflicts", m_stats.m_tier_conflicts[TIER_LOCAL]);
+        st.update("sat tier core memory", bytes[TIER_CORE] / mb);
+        st.update("sat tier 2 memory", bytes[TIER_2] / mb);
+        st.update("sat tier local memory", bytes[TIER_LOCAL] / mb);
+        if (secs > 0) {
+            st.update("sat tier core conflicts/sec", m_stats.m_tier_conflicts[TIER_CORE] / secs);
+            st.update("sat tier 2 conflicts/sec", m_stats.m_tier_conflicts[TIER_2] / secs);
+            st.update("sat tier local conflicts/sec", m_stats.m_tier_conflicts[TIER_LOCAL] / secs);
+        }
+    }
+
     void solver::reset_statistics() {
         m_stats.reset();
         m_cleaner.reset_statistics();
         m_simplifier.reset_statistics();
         m_asymm_branch.reset_statistics();
+        m_vivify.reset_statistics();
         m_probing.reset_statistics();
         m_aux_stats.reset();
     }
@@ -4916,6 +5071,7 @@ namespace sat {
         st.update("sat propagations 3ary", m_ter_propagate);
         st.update("sat propagations nary", m_propagate);
         st.update("sat restarts", m_restart);
+        st.update("sat restart reused levels", m_restart_reused);
         st.update("sat minimized lits", m_minimized_lits);
         st.update("sat subs resolution dyn", m_dyn_sub_res);
         st.update("sat blocked correction sets", m_blocked_corr_sets);
@@ -4924,6 +5080,7 @@ namespace sat {
         st.update("sat elim bool vars bdd", m_elim_var_bdd);
         st.update("sat backjumps", m_backjumps);
         st.update("sat backtracks", m_backtracks);
+        st.update("sat arena reorder", m_arena_reorder);
     }
 
     void stats::reset() {
@@ -34,6 +34,7 @@ Revision History:
 #include "sat/sat_probing.h"
 #include "sat/sat_mus.h"
 #include "sat/sat_binspr.h"
+#include "sat/sat_vivify.h"
 #include "sat/sat_drat.h"
 #include "sat/sat_parallel.h"
 #include "sat/sat_local_search.h"
@@ -62,6 +63,7 @@ namespace sat {
         unsigned m_ter_propagate;
         unsigned m_decision;
         unsigned m_restart;
+        unsigned m_restart_reused;
         unsigned m_gc_clause;
         unsigned m_del_clause;
         unsigned m_minimized_lits;
@@ -73,6 +75,8 @@ namespace sat {
         unsigned m_units;
         unsigned m_backtracks;
         unsigned m_backjumps;
+        unsigned m_arena_reorder;
+        unsigned m_tier_conflicts[3];
         stats() { reset(); }
         void reset();
         void collect_statistics(statistics & st) const;
@@ -104,6 +108,7 @@ namespace sat {
         probing                 m_probing;
         mus                     m_mus;           // MUS for minimal core extraction
         binspr                  m_binspr;
+        vivify                  m_vivify;
         bool                    m_inconsistent;
         bool                    m_searching;
         // A conflict is usually a single justification. That is, a justification
@@ -161,6 +166,7 @@ namespace sat {
         ema                     m_trail_avg;
         literal_vector          m_trail;
         clause_wrapper_vector   m_clauses_to_reinit;
+        unsigned_vector         m_arena_order;  // offsets of small arena clauses in the order they were used for propagation
         std::string             m_reason_unknown;
 
         svector<unsigned>       m_visited;
@@ -180,7 +186,6 @@ namespace sat {
         literal_vector          m_core;             // unsat core
 
         unsigned                m_par_id;        
-        unsigned                m_par_limit_in;
         unsigned                m_par_limit_out;
         unsigned                m_par_num_vars;
         bool                    m_par_syncing_clauses;
@@ -197,6 +202,7 @@ namespace sat {
         friend class asymm_branch;
         friend class big;
         friend class binspr;
+        friend class vivify;
         friend class drat;
         friend class elim_eqs;
         friend class bcd;
@@ -215,8 +221,10 @@ namespace sat {
         friend class unit_walk;
         friend struct mk_stat;
         friend class elim_vars;
+        friend class bva;
         friend class scoped_detach;
         friend class xor_finder;
+        friend class xor_gauss;
         friend class aig_finder;
         friend class lut_finder;
         friend class npn3_finder;
@@ -233,6 +241,7 @@ namespace sat {
         static void collect_param_descrs(param_descrs & d);
 
         void collect_statistics(statistics & st) const override;
+        void collect_tier_statistics(statistics & st) const;
         void reset_statistics();
         void display_status(std::ostream & out) const override;
         
@@ -268,6 +277,13 @@ namespace sat {
         inline void     dealloc_clause(clause* c) { cls_allocator().del_clause(c); }
         struct cmp_activity;
         void defrag_clauses();
+        void reorder_small_arena();
+        void mark_arena_use(clause& c, clause_offset cls_off) {
+            if (c.in_small_arena() && !c.on_arena_queue()) {
+                c.set_arena_queue(true);
+                m_arena_order.push_back(cls_off);
+            }
+        }
         bool should_defrag();
         bool memory_pressure();
         void del_clause(clause & c);
@@ -529,6 +545,8 @@ namespace sat {
         void save_psm();
         void gc_half(char const * st_name);
         void gc_dyn_psm();
+        void gc_tiered();
+        clause_tier glue2tier(unsigned glue) const;
         bool activate_frozen_clause(clause & c);
         unsigned psm(clause const & c) const;
         bool can_delete(clause const & c) const;
@@ -113,8 +113,8 @@ namespace sat {
     typedef svector<literal> literal_vector;
     typedef std::pair<literal, literal> literal_pair;
 
-    typedef size_t clause_offset;
-    typedef size_t ext_constraint_idx;
+    typedef unsigned clause_offset;
+    typedef unsigned ext_constraint_idx;
     typedef size_t ext_justification_idx;
 
     struct literal2unsigned { unsigned operator()(literal l) const { return l.to_uint(); } };
@@ -0,0 +1,239 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    sat_vivify.cpp
+
+Abstract:
+
+    Vivification of learned clauses.
+
+--*/
+#include "sat/sat_vivify.h"
+#include "sat/sat_vivify_params.hpp"
+#include "sat/sat_solver.h"
+#include "util/stopwatch.h"
+#include "util/trace.h"
+
+namespace sat {
+
+    vivify::vivify(solver& _s, params_ref const& p):
+        s(_s),
+        m_counter(0),
+        m_calls(0) {
+        updt_params(p);
+        reset_statistics();
+    }
+
+    struct vivify::report {
+        vivify&   m_vivify;
+        stopwatch m_watch;
+        unsigned  m_checked;
+        unsigned  m_elim_literals;
+        unsigned  m_deleted;
+        unsigned  m_units;
+        report(vivify& v):
+            m_vivify(v),
+            m_checked(v.m_checked[0] + v.m_checked[1] + v.m_checked[2]),
+            m_elim_literals(v.m_elim_literals),
+            m_deleted(v.m_deleted),
+            m_units(v.s.init_trail_size()) {
+            m_watch.start();
+        }
+
+        ~report() {
+            m_watch.stop();
+            IF_VERBOSE(2,
+                       vivify& v = m_vivify;
+                       unsigned checked = v.m_checked[0] + v.m_checked[1] + v.m_checked[2] - m_checked;
+                       unsigned elim_lits = v.m_elim_literals - m_elim_literals;
+                       unsigned deleted = v.m_deleted - m_deleted;
+                       unsigned num_units = v.s.init_trail_size() - m_units;
+                       verbose_stream() << " (sat-vivify :checked " << checked;
+                       if (elim_lits > 0) verbose_stream() << " :elim-literals " << elim_lits;
+                       if (deleted > 0)   verbose_stream() << " :deleted " << deleted;
+                       if (num_units > 0) verbose_stream() << " :units " << num_units;
+                       verbose_stream() << mem_stat();
+                       verbose_stream() << m_watch << ")\n";);
+        }
+    };
+
+    vivify::tier vivify::get_tier(clause const& c) const {
+        if (c.glue() <= m_tier1_glue) return tier1;
+        if (c.glue() <= m_tier2_glue) return tier2;
+        return local;
+    }
+
+    void vivify::operator()() {
+        if (!m_vivify || s.m_learned.empty())
+            return;
+        ++m_calls;
+        if (m_calls <= m_delay)
+            return;
+        SASSERT(s.at_base_lvl());
+        s.propagate(false);
+        if (s.inconsistent())
+            return;
+        report _rpt(*this);
+        process(tier1);
+        process(tier2);
+        process(local);
+    }
+
+    /**
+       \brief vivify learned clauses of tier t until the budget for the tier is exhausted.
+       Clauses are vivified at most once until all clauses in the tier have been vivified.
+     */
+    void vivify::process(tier t) {
+        clause_vector& clauses = s.m_learned;
+        bool has_candidate = false;
+        for (clause* c : clauses) {
+            if (!c->was_vivified() && get_tier(*c) == t) {
+                has_candidate = true;
+                break;
+            }
+        }
+        if (!has_candidate) {
+            for (clause* c : clauses)
+                if (get_tier(*c) == t)
+                    c->set_vivified(false);
+        }
+
+        m_counter = m_limit[t];
+        clause_vector::iterator it  = clauses.begin();
+        clause_vector::iterator it2 = it;
+        clause_vector::iterator end = clauses.end();
+        for (; it != end; ++it) {
+            clause& c = *(*it);
+            if (m_counter <= 0 || s.inconsistent() || c.was_removed() || c.frozen() ||
+                c.was_vivified() || get_tier(c) != t) {
+                *it2 = *it;
+                ++it2;
+                continue;
+            }
+            s.checkpoint();
+            if (std::any_of(c.begin(), c.end(), [&](literal l) { return s.value(l) == l_true; })) {
+                s.detach_clause(c);
+                s.del_clause(c);
+                ++m_deleted;
+                continue;
+            }
+            scoped_detach scoped_d(s, c);
+            if (!process(scoped_d, c, t))
+                continue; // clause was removed
+            *it2 = *it;
+            ++it2;
+        }
+        clauses.set_end(it2);
+        if (!s.inconsistent())
+            s.propagate(false);
+    }
+
+    bool vivify::process(scoped_detach& scoped_d, clause& c, tier t) {
+        TRACE("sat_vivify", tout << "vivify: " << c << "\n";);
+        SASSERT(s.at_base_lvl());
+        SASSERT(s.m_trail.size() == s.m_qhead);
+        c.set_vivified(true);
+        ++m_checked[t];
+        m_counter -= c.size();
+
+        unsigned sz = c.size(), j = 0;
+        bool done = false;
+        s.push();
+        for (unsigned i = 0; !done && i < sz; ++i) {
+            literal l = c[i];
+            switch (s.value(l)) {
+            case l_false:
+                // ~c[0], .., ~c[j-1] imply ~l
+                break;
+            case l_true:
+                // ~c[0], .., ~c[j-1] imply l
+                std::swap(c[i], c[j++]);
+                done = true;
+                break;
+            case l_undef: {
+                std::swap(c[i], c[j++]);
+                unsigned trail_sz = s.m_trail.size();
+                s.assign_scoped(~l);
+                s.propagate_core(false); // must not use propagate(), since check_missed_propagation may fail for c
+                m_counter -= s.m_trail.size() - trail_sz;
+                done = s.inconsistent();
+                break;
+            }
+            }
+        }
+        s.pop(1);
+        SASSERT(!s.inconsistent());
+        if (j == sz)
+            return true;
+        return re_attach(scoped_d, c, j, t);
+    }
+
+    bool vivify::re_attach(scoped_detach& scoped_d, clause& c, unsigned new_sz, tier t) {
+        unsigned old_sz = c.size();
+        m_elim_literals += old_sz - new_sz;
+        ++m_shrunk[t];
+        switch (new_sz) {
+        case 0:
+            s.set_conflict();
+            return true;
+        case 1:
+            TRACE("sat_vivify", tout << "produced unit clause: " << c[0] << "\n";);
+            ++m_units;
+            s.assign_unit(c[0]);
+            s.propagate_core(false);
+            scoped_d.del_clause();
+            return false;
+        case 2:
+            SASSERT(s.value(c[0]) == l_undef && s.value(c[1]) == l_undef);
+            s.mk_bin_clause(c[0], c[1], c.is_learned());
+            if (s.m_trail.size() > s.m_qhead) s.propagate_core(false);
+            scoped_d.del_clause();
+            return false;
+        default:
+            s.shrink(c, old_sz, new_sz);
+            if (c.glue() > new_sz)
+                c.set_glue(new_sz);
+            return true;
+        }
+    }
+
+    void vivify::updt_params(params_ref const& _p) {
+        sat_vivify_params p(_p);
+        m_vivify        = p.vivify();
+        m_delay         = p.vivify_delay();
+        m_tier1_glue    = p.vivify_tier1_glue();
+        m_tier2_glue    = p.vivify_tier2_glue();
+        m_limit[tier1]  = p.vivify_tier1_limit();
+        m_limit[tier2]  = p.vivify_tier2_limit();
+        m_limit[local]  = p.vivify_local_limit();
+    }
+
+    void vivify::collect_param_descrs(param_descrs& d) {
+        sat_vivify_params::collect_param_descrs(d);
+    }
+
+    void vivify::collect_statistics(statistics& st) const {
+        st.update("sat vivify tier1 checked", m_checked[tier1]);
+        st.update("sat vivify tier1 shrunk", m_shrunk[tier1]);
+        st.update("sat vivify tier2 checked", m_checked[tier2]);
+        st.update("sat vivify tier2 shrunk", m_shrunk[tier2]);
+        st.update("sat vivify local checked", m_checked[local]);
+        st.update("sat vivify local shrunk", m_shrunk[local]);
+        st.update("sat vivify elim literals", m_elim_literals);
+        st.update("sat vivify deleted", m_deleted);
+        st.update("sat vivify units", m_units);
+    }
+
+    void vivify::reset_statistics() {
+        for (unsigned t = 0; t < 3; ++t) {
+            m_checked[t] = 0;
+            m_shrunk[t] = 0;
+        }
+        m_elim_literals = 0;
+        m_deleted = 0;
+        m_units = 0;
+    }
+
+};
@@ -0,0 +1,72 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    sat_vivify.h
+
+Abstract:
+
+    Vivification of learned clauses.
+
+    A clause C = l1 \/ ... \/ ln is vivified by assigning ~l1, ~l2, ...
+    in turn at a fresh scope and propagating without C.
+    - If ~l1, .., ~lk produce a conflict, then l1 \/ .. \/ lk is implied.
+    - If ~l1, .., ~lk imply l, then l1 \/ .. \/ lk \/ l is implied.
+    - If ~l1, .., ~lk imply ~l, then l can be removed from C.
+
+    Learned clauses are processed in tiers by glue,
+    where each tier has its own budget of visited literals.
+
+--*/
+#pragma once
+
+#include "util/params.h"
+#include "util/statistics.h"
+#include "sat/sat_clause.h"
+#include "sat/sat_types.h"
+
+namespace sat {
+    class solver;
+    class scoped_detach;
+
+    class vivify {
+        struct report;
+
+        enum tier { tier1 = 0, tier2 = 1, local = 2 };
+
+        solver&    s;
+        int64_t    m_counter;
+        unsigned   m_calls;
+
+        // config
+        bool       m_vivify;
+        unsigned   m_delay;
+        unsigned   m_tier1_glue;
+        unsigned   m_tier2_glue;
+        unsigned   m_limit[3];
+
+        // stats
+        unsigned   m_checked[3];
+        unsigned   m_shrunk[3];
+        unsigned   m_elim_literals;
+        unsigned   m_deleted;
+        unsigned   m_units;
+
+        tier get_tier(clause const& c) const;
+        void process(tier t);
+        bool process(scoped_detach& scoped_d, clause& c, tier t);
+        bool re_attach(scoped_detach& scoped_d, clause& c, unsigned new_sz, tier t);
+
+    public:
+        vivify(solver& s, params_ref const& p);
+
+        void operator()();
+
+        void updt_params(params_ref const& p);
+        static void collect_param_descrs(param_descrs& d);
+
+        void collect_statistics(statistics& st) const;
+        void reset_statistics();
+    };
+}
@@ -33,6 +33,10 @@ namespace sat {
        For binary clauses: we use a bit to store whether the binary clause was learned or not.
        
        Remark: there are no clause objects for binary clauses.
+
+       A watched element is packed into two 32 bit words, so that it fits in 8 bytes.
+       Clause offsets are 32 bit clause ids resolved by the clause_allocator,
+       and external constraint indices are 32 bit ids resolved by the extension.
     */
 
     class extension;
@@ -43,7 +47,7 @@ namespace sat {
             BINARY = 0, TERNARY, CLAUSE, EXT_CONSTRAINT
         };
     private:
-        size_t   m_val1;
+        unsigned m_val1;
         unsigned m_val2; 
     public:
         watched(literal l, bool learned):
@@ -86,7 +90,7 @@ namespace sat {
         kind get_kind() const { return static_cast<kind>(m_val2 & 3); }
        
         bool is_binary_clause() const { return get_kind() == BINARY; }
-        literal get_literal() const { SASSERT(is_binary_clause()); return to_literal(static_cast<unsigned>(m_val1)); }
+        literal get_literal() const { SASSERT(is_binary_clause()); return to_literal(m_val1); }
         void set_literal(literal l) { SASSERT(is_binary_clause()); m_val1 = l.to_uint(); }
         bool is_learned() const { SASSERT(is_binary_clause()); return ((m_val2 >> 2) & 1) == 1; }
 
@@ -96,11 +100,11 @@ namespace sat {
         void set_learned(bool l) { if (l) m_val2 |= 4u; else m_val2 &= ~4u; SASSERT(is_learned() == l); }
                 
         bool is_ternary_clause() const { return get_kind() == TERNARY; }
-        literal get_literal1() const { SASSERT(is_ternary_clause()); return to_literal(static_cast<unsigned>(m_val1)); }
+        literal get_literal1() const { SASSERT(is_ternary_clause()); return to_literal(m_val1); }
         literal get_literal2() const { SASSERT(is_ternary_clause()); return to_literal(m_val2 >> 2); }
 
         bool is_clause() const { return get_kind() == CLAUSE; }
-        clause_offset get_clause_offset() const { SASSERT(is_clause()); return static_cast<clause_offset>(m_val1); }
+        clause_offset get_clause_offset() const { SASSERT(is_clause()); return m_val1; }
         literal get_blocked_literal() const { SASSERT(is_clause()); return to_literal(m_val2 >> 2); }
         void set_clause_offset(clause_offset c) { SASSERT(is_clause()); m_val1 = c; }
         void set_blocked_literal(literal l) { SASSERT(is_clause()); m_val2 = static_cast<unsigned>(CLAUSE) + (l.to_uint() << 2); }
@@ -116,6 +120,7 @@ namespace sat {
         bool operator!=(watched const & w) const { return !operator==(w); }
     };
 
+    static_assert(sizeof(watched) == 8, "watched elements are packed into 8 bytes");
     static_assert(0 <= watched::BINARY && watched::BINARY <= 3, "");
     static_assert(0 <= watched::TERNARY && watched::TERNARY <= 3, "");
     static_assert(0 <= watched::CLAUSE && watched::CLAUSE <= 3, "");
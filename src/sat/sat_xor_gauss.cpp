@@ -0,0 +1,368 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    sat_xor_gauss.cpp
+
+Abstract:
+
+    Gauss-Jordan elimination over XOR constraints.
+
+--*/
+#include "sat/sat_xor_gauss.h"
+#include "sat/sat_solver.h"
+#include "util/trace.h"
+
+namespace sat {
+
+    xor_gauss::xor_gauss():
+        m_solver(nullptr),
+        m_attached(false),
+        m_num_rows(0),
+        m_num_cols(0),
+        m_num_words(0) {
+    }
+
+    void xor_gauss::reset() {
+        if (m_attached) {
+            for (unsigned c = 0; c < m_num_cols; ++c) {
+                bool_var v = m_col2var[c];
+                if (m_col2rows[c].empty() || v >= s().num_vars())
+                    continue;
+                s().get_wlist(literal(v, false)).erase(watched(tag));
+                s().get_wlist(literal(v, true)).erase(watched(tag));
+            }
+        }
+        m_attached = false;
+        m_xors.reset();
+        m_num_rows = m_num_cols = m_num_words = 0;
+        m_rows.reset();
+        m_rhs.reset();
+        m_col2var.reset();
+        m_var2col.reset();
+        m_col2rows.reset();
+        m_assigned.reset();
+        m_values.reset();
+        m_trail.reset();
+        m_trail_lim.reset();
+        m_reason_lits.reset();
+        m_reason_begin.reset();
+        m_reason_lim.reset();
+    }
+
+    bool xor_gauss::init(solver& _s, unsigned max_vars) {
+        SASSERT(!m_attached);
+        SASSERT(_s.at_base_lvl());
+        m_solver = &_s;
+        ++m_stats.m_num_inits;
+        bool ok = mk_matrix(max_vars);
+        m_xors.reset();
+        if (!ok)
+            return false;
+        eliminate();
+        if (!compact() || m_num_rows == 0)
+            return false;
+        attach();
+        IF_VERBOSE(2, verbose_stream() << "(sat.gauss :rows " << m_num_rows << " :vars " << m_num_cols << ")\n";);
+        return true;
+    }
+
+    /**
+       \brief create a row for each XOR over the unassigned variables.
+       The XOR l1 ^ .. ^ ln = true of literals is stored as
+       the equation v1 + .. + vn = rhs over variables, where the signs
+       and assigned variables are folded into rhs.
+     */
+    bool xor_gauss::mk_matrix(unsigned max_vars) {
+        if (m_xors.size() < 2)
+            return false;
+        m_var2col.resize(s().num_vars(), UINT_MAX);
+        for (literal_vector const& x : m_xors) {
+            for (literal lit : x) {
+                bool_var v = lit.var();
+                if (s().value(v) == l_undef && m_var2col[v] == UINT_MAX) {
+                    m_var2col[v] = m_col2var.size();
+                    m_col2var.push_back(v);
+                }
+            }
+        }
+        m_num_cols = m_col2var.size();
+        if (m_num_cols == 0 || m_num_cols > max_vars)
+            return false;
+        m_num_words = (m_num_cols + 63) / 64;
+        m_num_rows = m_xors.size();
+        m_rows.resize(m_num_rows * m_num_words, 0);
+        m_rhs.resize(m_num_rows, false);
+        for (unsigned r = 0; r < m_num_rows; ++r) {
+            bool rhs = true;
+            for (literal lit : m_xors[r]) {
+                rhs ^= lit.sign();
+                switch (s().value(lit.var())) {
+                case l_undef: toggle_bit(row(r), m_var2col[lit.var()]); break;
+                case l_true: rhs = !rhs; break;
+                default: break;
+                }
+            }
+            m_rhs[r] = rhs;
+        }
+        return true;
+    }
+
+    void xor_gauss::add_row(unsigned dst, unsigned src) {
+        uint64_t* d = row(dst);
+        uint64_t const* r = row(src);
+        for (unsigned i = 0; i < m_num_words; ++i)
+            d[i] ^= r[i];
+        m_rhs[dst] = m_rhs[dst] != m_rhs[src];
+    }
+
+    void xor_gauss::swap_rows(unsigned r1, unsigned r2) {
+        if (r1 == r2)
+            return;
+        uint64_t* a = row(r1);
+        uint64_t* b = row(r2);
+        for (unsigned i = 0; i < m_num_words; ++i)
+            std::swap(a[i], b[i]);
+        bool t = m_rhs[r1];
+        m_rhs[r1] = m_rhs[r2];
+        m_rhs[r2] = t;
+    }
+
+    /**
+       \brief bring the matrix into reduced row echelon form.
+     */
+    void xor_gauss::eliminate() {
+        unsigned rank = 0;
+        for (unsigned c = 0; c < m_num_cols && rank < m_num_rows; ++c) {
+            unsigned p = rank;
+            while (p < m_num_rows && !get_bit(row(p), c))
+                ++p;
+            if (p == m_num_rows)
+                continue;
+            swap_rows(p, rank);
+            for (unsigned r = 0; r < m_num_rows; ++r)
+                if (r != rank && get_bit(row(r), c))
+                    add_row(r, rank);
+            ++rank;
+        }
+    }
+
+    /**
+       \brief remove empty rows and assign rows with a single column.
+       Returns false if an empty row has an odd right-hand side.
+     */
+    bool xor_gauss::compact() {
+        unsigned j = 0;
+        for (unsigned r = 0; r < m_num_rows; ++r) {
+            uint64_t const* rw = row(r);
+            unsigned num_bits = 0, col = UINT_MAX;
+            for (unsigned i = 0; i < m_num_words && num_bits < 2; ++i) {
+                uint64_t w = rw[i];
+                if (w == 0)
+                    continue;
+                num_bits += (w & (w - 1)) ? 2 : 1;
+                col = 64 * i + uint64_log2(w);
+            }
+            if (num_bits == 0) {
+                if (m_rhs[r]) {
+                    TRACE("sat_gauss", tout << "inconsistent xors\n";);
+                    s().set_conflict(justification(0));
+                    return false;
+                }
+                continue;
+            }
+            if (num_bits == 1) {
+                literal lit(m_col2var[col], !m_rhs[r]);
+                ++m_stats.m_num_units;
+                if (s().value(lit) == l_undef)
+                    s().assign_unit(lit);
+                continue;
+            }
+            if (j != r) {
+                uint64_t* dst = row(j);
+                for (unsigned i = 0; i < m_num_words; ++i)
+                    dst[i] = rw[i];
+                m_rhs[j] = m_rhs[r];
+            }
+            ++j;
+        }
+        m_num_rows = j;
+        m_rows.shrink(j * m_num_words);
+        m_rhs.shrink(j);
+        return true;
+    }
+
+    void xor_gauss::attach() {
+        m_col2rows.reset();
+        m_col2rows.resize(m_num_cols);
+        for (unsigned r = 0; r < m_num_rows; ++r) {
+            uint64_t const* rw = row(r);
+            for (unsigned i = 0; i < m_num_words; ++i) {
+                for (uint64_t w = rw[i]; w != 0; ) {
+                    uint64_t low = w & (0 - w);
+                    m_col2rows[64 * i + uint64_log2(low)].push_back(r);
+                    w ^= low;
+                }
+            }
+        }
+        for (unsigned c = 0; c < m_num_cols; ++c) {
+            if (m_col2rows[c].empty())
+                continue;
+            bool_var v = m_col2var[c];
+            s().get_wlist(literal(v, false)).push_back(watched(tag));
+            s().get_wlist(literal(v, true)).push_back(watched(tag));
+        }
+        m_assigned.resize(m_num_words, 0);
+        m_values.resize(m_num_words, 0);
+        m_stats.m_num_rows += m_num_rows;
+        m_attached = true;
+    }
+
+    bool xor_gauss::propagate(literal l) {
+        SASSERT(m_attached);
+        bool_var v = l.var();
+        unsigned c = v < m_var2col.size() ? m_var2col[v] : UINT_MAX;
+        if (c == UINT_MAX || get_bit(m_assigned.c_ptr(), c))
+            return true;
+        set_bit(m_assigned.c_ptr(), c);
+        if (!l.sign())
+            set_bit(m_values.c_ptr(), c);
+        m_trail.push_back(c);
+        for (unsigned r : m_col2rows[c])
+            if (!check_row(r, c))
+                break;
+        return true;
+    }
+
+    /**
+       \brief check row r after column c was assigned.
+       Returns false if the row is in conflict.
+     */
+    bool xor_gauss::check_row(unsigned r, unsigned c) {
+        uint64_t const* rw = row(r);
+        unsigned ucol = UINT_MAX;
+        bool parity = m_rhs[r];
+        for (unsigned i = 0; i < m_num_words; ++i) {
+            uint64_t u = rw[i] & ~m_assigned[i];
+            if (u != 0) {
+                if (ucol != UINT_MAX || (u & (u - 1)) != 0)
+                    return true;
+                ucol = 64 * i + uint64_log2(u);
+            }
+            uint64_t p = rw[i] & m_values[i];
+            parity ^= (get_num_1bits(static_cast<unsigned>(p ^ (p >> 32))) & 1) != 0;
+        }
+        if (ucol == UINT_MAX) {
+            if (!parity)
+                return true;
+            literal t(m_col2var[c], !get_bit(m_values.c_ptr(), c));
+            unsigned idx = mk_reason(r, c);
+            ++m_stats.m_num_conflicts;
+            TRACE("sat_gauss", tout << "conflict " << ~t << "\n";);
+            s().set_conflict(justification::mk_ext_justification(s().scope_lvl(), tag | idx), t);
+            return false;
+        }
+        literal p(m_col2var[ucol], !parity);
+        switch (s().value(p)) {
+        case l_true:
+            return true;
+        case l_undef: {
+            unsigned idx = mk_reason(r, ucol);
+            ++m_stats.m_num_propagations;
+            TRACE("sat_gauss", tout << "propagate " << p << "\n";);
+            s().assign(p, justification::mk_ext_justification(s().scope_lvl(), tag | idx));
+            return true;
+        }
+        default: {
+            unsigned idx = mk_reason(r, ucol);
+            ++m_stats.m_num_conflicts;
+            TRACE("sat_gauss", tout << "conflict " << p << "\n";);
+            s().set_conflict(justification::mk_ext_justification(s().scope_lvl(), tag | idx), ~p);
+            return false;
+        }
+        }
+    }
+
+    /**
+       \brief store the true literals of the assigned columns of row r, other than c.
+     */
+    unsigned xor_gauss::mk_reason(unsigned r, unsigned c) {
+        unsigned idx = m_reason_begin.size();
+        m_reason_begin.push_back(m_reason_lits.size());
+        uint64_t const* rw = row(r);
+        for (unsigned i = 0; i < m_num_words; ++i) {
+            for (uint64_t w = rw[i] & m_assigned[i]; w != 0; ) {
+                uint64_t low = w & (0 - w);
+                unsigned col = 64 * i + uint64_log2(low);
+                w ^= low;
+                if (col != c)
+                    m_reason_lits.push_back(literal(m_col2var[col], !get_bit(m_values.c_ptr(), col)));
+            }
+        }
+        return idx;
+    }
+
+    void xor_gauss::get_antecedents(literal l, size_t idx, literal_vector& r) const {
+        unsigned k = static_cast<unsigned>(idx & ~static_cast<size_t>(tag));
+        SASSERT(k < m_reason_begin.size());
+        unsigned end = k + 1 < m_reason_begin.size() ? m_reason_begin[k + 1] : m_reason_lits.size();
+        for (unsigned i = m_reason_begin[k]; i < end; ++i)
+            r.push_back(m_reason_lits[i]);
+    }
+
+    void xor_gauss::push() {
+        if (!m_attached)
+            return;
+        m_trail_lim.push_back(m_trail.size());
+        m_reason_lim.push_back(m_reason_begin.size());
+    }
+
+    void xor_gauss::pop(unsigned n) {
+        if (!m_attached)
+            return;
+        SASSERT(n <= m_trail_lim.size());
+        unsigned lim = m_trail_lim.size() - n;
+        unsigned sz = m_trail_lim[lim];
+        for (unsigned i = sz; i < m_trail.size(); ++i) {
+            unset_bit(m_assigned.c_ptr(), m_trail[i]);
+            unset_bit(m_values.c_ptr(), m_trail[i]);
+        }
+        m_trail.shrink(sz);
+        m_trail_lim.shrink(lim);
+        unsigned rsz = m_reason_lim[lim];
+        if (rsz < m_reason_begin.size()) {
+            m_reason_lits.shrink(m_reason_begin[rsz]);
+            m_reason_begin.shrink(rsz);
+        }
+        m_reason_lim.shrink(lim);
+    }
+
+    std::ostream& xor_gauss::display(std::ostream& out) const {
+        for (unsigned r = 0; r < m_num_rows; ++r) {
+            char const* sep = "";
+            for (unsigned c = 0; c < m_num_cols; ++c) {
+                if (get_bit(row(r), c)) {
+                    out << sep << "v" << m_col2var[c];
+                    sep = " + ";
+                }
+            }
+            out << " = " << (m_rhs[r] ? 1 : 0) << "\n";
+        }
+        return out;
+    }
+
+    std::ostream& xor_gauss::display_justification(std::ostream& out, size_t idx) const {
+        literal_vector lits;
+        get_antecedents(null_literal, idx, lits);
+        return out << "gauss " << lits;
+    }
+
+    void xor_gauss::collect_statistics(statistics& st) const {
+        st.update("ba gauss inits", m_stats.m_num_inits);
+        st.update("ba gauss rows", m_stats.m_num_rows);
+        st.update("ba gauss units", m_stats.m_num_units);
+        st.update("ba gauss propagations", m_stats.m_num_propagations);
+        st.update("ba gauss conflicts", m_stats.m_num_conflicts);
+    }
+}
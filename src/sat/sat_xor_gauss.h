@@ -0,0 +1,122 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    sat_xor_gauss.h
+
+Abstract:
+
+    Gauss-Jordan elimination over XOR constraints.
+
+    The XOR constraints of the cardinality extension are collected
+    into a dense bit-matrix over the unassigned variables at base level.
+    The matrix is brought into reduced row echelon form once, and
+    rows are then checked using 64-bit word operations against the
+    current assignment:
+    - a row with one unassigned column propagates that column,
+    - a fully assigned row with the wrong parity is a conflict.
+    The reason for a propagation is the set of other assigned columns
+    of the row. Reasons are stored on a scoped trail, such that
+    justifications remain valid until the propagated literal is unassigned.
+
+--*/
+#pragma once
+
+#include <cstring>
+#include "sat/sat_types.h"
+#include "util/statistics.h"
+
+namespace sat {
+    class solver;
+
+    class xor_gauss {
+    public:
+        // constraint and justification indices owned by Gauss-Jordan elimination
+        static const unsigned tag = 0x80000000;
+        static bool is_gauss(size_t idx) { return (idx & tag) != 0; }
+
+    private:
+        struct stats {
+            unsigned m_num_inits;
+            unsigned m_num_rows;
+            unsigned m_num_units;
+            unsigned m_num_propagations;
+            unsigned m_num_conflicts;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        solver*                 m_solver;
+        stats                   m_stats;
+        bool                    m_attached;
+        vector<literal_vector>  m_xors;       // input constraints
+
+        // matrix
+        unsigned                m_num_rows;
+        unsigned                m_num_cols;
+        unsigned                m_num_words;
+        svector<uint64_t>       m_rows;       // row r occupies the words [r*m_num_words, (r+1)*m_num_words)
+        bool_vector             m_rhs;
+        svector<bool_var>       m_col2var;
+        unsigned_vector         m_var2col;
+        vector<unsigned_vector> m_col2rows;
+
+        // assignment to columns
+        svector<uint64_t>       m_assigned;
+        svector<uint64_t>       m_values;
+        unsigned_vector         m_trail;
+        unsigned_vector         m_trail_lim;
+
+        // reasons for propagations and conflicts
+        literal_vector          m_reason_lits;
+        unsigned_vector         m_reason_begin;
+        unsigned_vector         m_reason_lim;
+
+        solver& s() const { return *m_solver; }
+        uint64_t* row(unsigned r) { return m_rows.c_ptr() + r * m_num_words; }
+        uint64_t const* row(unsigned r) const { return m_rows.c_ptr() + r * m_num_words; }
+        static bool get_bit(uint64_t const* w, unsigned c) { return (w[c >> 6] & (1ull << (c & 63))) != 0; }
+        static void set_bit(uint64_t* w, unsigned c) { w[c >> 6] |= (1ull << (c & 63)); }
+        static void unset_bit(uint64_t* w, unsigned c) { w[c >> 6] &= ~(1ull << (c & 63)); }
+        static void toggle_bit(uint64_t* w, unsigned c) { w[c >> 6] ^= (1ull << (c & 63)); }
+
+        bool mk_matrix(unsigned max_vars);
+        void add_row(unsigned dst, unsigned src);
+        void swap_rows(unsigned r1, unsigned r2);
+        void eliminate();
+        bool compact();
+        void attach();
+        bool check_row(unsigned r, unsigned c);
+        unsigned mk_reason(unsigned r, unsigned c);
+
+    public:
+        xor_gauss();
+
+        /**
+           \brief remove the matrix and its watches.
+         */
+        void reset();
+
+        void add_xor(literal_vector const& lits) { m_xors.push_back(lits); }
+
+        /**
+           \brief build the matrix from the added XORs at base level.
+           Returns false if the matrix was not attached, because it is trivial,
+           exceeds max_vars columns or the XORs are inconsistent.
+         */
+        bool init(solver& s, unsigned max_vars);
+
+        bool is_attached() const { return m_attached; }
+
+        bool propagate(literal l);
+        void get_antecedents(literal l, size_t idx, literal_vector& r) const;
+        void push();
+        void pop(unsigned n);
+
+        std::ostream& display(std::ostream& out) const;
+        std::ostream& display_justification(std::ostream& out, size_t idx) const;
+        void collect_statistics(statistics& st) const;
+        void reset_statistics() { m_stats.reset(); }
+    };
+}
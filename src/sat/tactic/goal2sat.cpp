@@ -36,6 +36,7 @@ Notes:
 #include "sat/tactic/goal2sat.h"
 #include "sat/ba_solver.h"
 #include "sat/sat_cut_simplifier.h"
+#include "sat/sat_params.hpp"
 #include "model/model_evaluator.h"
 #include "model/model_v2_pp.h"
 #include "tactic/tactic.h"
@@ -92,7 +93,7 @@ struct goal2sat::imp {
         m_ite_extra  = p.get_bool("ite_extra", true);
         m_max_memory = megabytes_to_bytes(p.get_uint("max_memory", UINT_MAX));
         m_xor_solver = p.get_bool("xor_solver", false);
-        if (m_xor_solver) ensure_extension();
+        if (m_xor_solver || sat_params(p).xor_gauss()) ensure_extension();
     }
 
     void throw_op_not_handled(std::string const& s) {
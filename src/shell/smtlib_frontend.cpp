@@ -82,12 +82,12 @@ unsigned read_smtlib2_commands(char const * file_name) {
 
     bool result = true;
     if (file_name) {
-        std::ifstream in(file_name);
-        if (in.bad() || in.fail()) {
+        bool opened = true;
+        result = parse_smt2_commands_from_file(ctx, file_name, opened);
+        if (!opened) {
             std::cerr << "(error \"failed to open file '" << file_name << "'\")" << std::endl;
             exit(ERR_OPEN_FILE);
         }
-        result = parse_smt2_commands(ctx, in);
     }
     else {
         result = parse_smt2_commands(ctx, std::cin, true);
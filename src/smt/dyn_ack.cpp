@@ -16,6 +16,7 @@ Author:
 Revision History:
 
 --*/
+#include <algorithm>
 #include "smt/smt_context.h"
 #include "smt/dyn_ack.h"
 #include "ast/ast_pp.h"
@@ -166,7 +167,10 @@ namespace smt {
     dyn_ack_manager::dyn_ack_manager(context & ctx, dyn_ack_params & p):
         m_context(ctx),
         m(ctx.get_manager()),
-        m_params(p) {
+        m_params(p),
+        m_stamp(0),
+        m_evict_lim(0) {
+        m_triple.m_evict_lim = 0;
     }
 
     dyn_ack_manager::~dyn_ack_manager() {
@@ -190,11 +194,124 @@ namespace smt {
         m_qhead = 0;
         m_num_instances = 0;
         m_num_propagations_since_last_gc = 0;
+        m_sketch.reset();
+        m_evict_lim = evict_lim(0);
 
         m_triple.m_app2num_occs.reset();
         reset_app_triples();
         m_triple.m_to_instantiate.reset();
         m_triple.m_qhead = 0;
+        m_triple.m_sketch.reset();
+        m_triple.m_evict_lim = evict_lim(0);
+    }
+
+    /**
+       \brief Determine the initial number of uses of a pair (triple) with hash h
+       that is not tracked exactly. Return false if it is not yet used often enough
+       to be tracked exactly.
+    */
+    bool dyn_ack_manager::promote(count_min_sketch & sketch, unsigned h, unsigned & num_occs) {
+        if (m_params.m_dack_max_pairs == 0) {
+            num_occs = 1;
+            return true;
+        }
+        unsigned est = sketch.inc(h);
+        if (est < m_params.m_dack_promote)
+            return false;
+        m_context.m_stats.m_num_dyn_ack_promotions++;
+        num_occs = std::max(1u, std::min(est, m_params.m_dack_threshold));
+        return true;
+    }
+
+    /**
+       \brief Return the stamp below which entries are evicted, such that
+       3/4 of m_dack_max_pairs entries remain.
+    */
+    uint64_t dyn_ack_manager::evict_stamp(svector<uint64_t> & stamps) {
+        unsigned keep = m_params.m_dack_max_pairs - m_params.m_dack_max_pairs / 4;
+        if (stamps.size() <= keep)
+            return 0;
+        unsigned k = stamps.size() - keep;
+        std::nth_element(stamps.begin(), stamps.begin() + k, stamps.end());
+        return stamps[k];
+    }
+
+    /**
+       \brief Return the number of entries at which the next eviction happens.
+       It grows geometrically with the entries that survive an eviction,
+       such that evictions that cannot remove entries are not repeated
+       for every new entry.
+    */
+    unsigned dyn_ack_manager::evict_lim(unsigned num_remaining) const {
+        return std::max(m_params.m_dack_max_pairs, num_remaining + std::max(1u, num_remaining / 4));
+    }
+
+    void dyn_ack_manager::evict_pairs() {
+        svector<uint64_t> stamps;
+        for (auto const& kv : m_app_pair2num_occs)
+            stamps.push_back(kv.get_value().m_stamp);
+        uint64_t cutoff = evict_stamp(stamps);
+        app_pair_vector evicted;
+        unsigned j = 0;
+        for (app_pair const& p : m_app_pairs) {
+            occs o;
+            if (!m_instantiated.contains(p) && m_app_pair2num_occs.find(p.first, p.second, o) && o.m_stamp < cutoff) {
+                TRACE("dyn_ack", tout << "evicting:\n" << mk_pp(p.first, m) << "\n" << mk_pp(p.second, m) << "\n";);
+                m_app_pair2num_occs.erase(p.first, p.second);
+                evicted.push_back(p);
+                continue;
+            }
+            m_app_pairs[j++] = p;
+        }
+        m_app_pairs.shrink(j);
+        // evicted pairs may be waiting for instantiation.
+        // They are removed before they are released.
+        j = m_qhead;
+        for (unsigned i = m_qhead; i < m_to_instantiate.size(); ++i) {
+            app_pair const& p = m_to_instantiate[i];
+            if (m_app_pair2num_occs.contains(p.first, p.second))
+                m_to_instantiate[j++] = p;
+        }
+        m_to_instantiate.shrink(j);
+        for (app_pair const& p : evicted) {
+            m.dec_ref(p.first);
+            m.dec_ref(p.second);
+        }
+        m_context.m_stats.m_num_dyn_ack_evictions += evicted.size();
+        m_evict_lim = evict_lim(m_app_pair2num_occs.size());
+    }
+
+    void dyn_ack_manager::evict_triples() {
+        svector<uint64_t> stamps;
+        for (auto const& kv : m_triple.m_app2num_occs)
+            stamps.push_back(kv.get_value().m_stamp);
+        uint64_t cutoff = evict_stamp(stamps);
+        app_triple_vector evicted;
+        unsigned j = 0;
+        for (app_triple const& p : m_triple.m_apps) {
+            occs o;
+            if (!m_triple.m_instantiated.contains(p) && m_triple.m_app2num_occs.find(p.first, p.second, p.third, o) && o.m_stamp < cutoff) {
+                m_triple.m_app2num_occs.erase(p.first, p.second, p.third);
+                evicted.push_back(p);
+                continue;
+            }
+            m_triple.m_apps[j++] = p;
+        }
+        m_triple.m_apps.shrink(j);
+        j = m_triple.m_qhead;
+        for (unsigned i = m_triple.m_qhead; i < m_triple.m_to_instantiate.size(); ++i) {
+            app_triple const& p = m_triple.m_to_instantiate[i];
+            if (m_triple.m_app2num_occs.contains(p.first, p.second, p.third))
+                m_triple.m_to_instantiate[j++] = p;
+        }
+        m_triple.m_to_instantiate.shrink(j);
+        for (app_triple const& p : evicted) {
+            m.dec_ref(p.first);
+            m.dec_ref(p.second);
+            m.dec_ref(p.third);
+        }
+        m_context.m_stats.m_num_dyn_ack_evictions += evicted.size();
+        m_triple.m_evict_lim = evict_lim(m_triple.m_app2num_occs.size());
     }
 
     void dyn_ack_manager::cg_eh(app * n1, app * n2) {
@@ -210,27 +327,29 @@ namespace smt {
         if (m_instantiated.contains(p)) {
             return;
         }
-        unsigned num_occs = 0;
-        if (m_app_pair2num_occs.find(n1, n2, num_occs)) {
-            TRACE("dyn_ack", tout << "used_cg_eh:\n" << mk_pp(n1, m) << "\n" << mk_pp(n2, m) << "\nnum_occs: " << num_occs << "\n";);
-            num_occs++;
+        occs o;
+        bool is_new = false;
+        if (m_app_pair2num_occs.find(n1, n2, o)) {
+            TRACE("dyn_ack", tout << "used_cg_eh:\n" << mk_pp(n1, m) << "\n" << mk_pp(n2, m) << "\nnum_occs: " << o.m_count << "\n";);
+            o.m_count++;
         }
         else {
-            num_occs = 1;
+            if (!promote(m_sketch, hash_u_u(n1->get_id(), n2->get_id()), o.m_count))
+                return;
+            is_new = true;
             m.inc_ref(n1);
             m.inc_ref(n2);
             m_app_pairs.push_back(p);
         }
-        SASSERT(num_occs > 0);
-        m_app_pair2num_occs.insert(n1, n2, num_occs);
-#ifdef Z3DEBUG
-        unsigned num_occs2 = 0;
-        SASSERT(m_app_pair2num_occs.find(n1, n2, num_occs2) && num_occs == num_occs2);
-#endif
-        if (num_occs == m_params.m_dack_threshold) {
-            TRACE("dyn_ack", tout << "found candidate:\n" << mk_pp(n1, m) << "\n" << mk_pp(n2, m) << "\nnum_occs: " << num_occs << "\n";);
+        SASSERT(o.m_count > 0);
+        o.m_stamp = m_stamp++;
+        m_app_pair2num_occs.insert(n1, n2, o);
+        if (o.m_count == m_params.m_dack_threshold) {
+            TRACE("dyn_ack", tout << "found candidate:\n" << mk_pp(n1, m) << "\n" << mk_pp(n2, m) << "\nnum_occs: " << o.m_count << "\n";);
             m_to_instantiate.push_back(p);
         }
+        if (is_new && m_params.m_dack_max_pairs > 0 && m_app_pair2num_occs.size() > m_evict_lim)
+            evict_pairs();
     }
 
     void dyn_ack_manager::eq_eh(app * n1, app * n2, app* r) {
@@ -245,37 +364,39 @@ namespace smt {
         if (m_triple.m_instantiated.contains(tr)) {
             return;
         }
-        unsigned num_occs = 0;
-        if (m_triple.m_app2num_occs.find(n1, n2, r, num_occs)) {
+        occs o;
+        bool is_new = false;
+        if (m_triple.m_app2num_occs.find(n1, n2, r, o)) {
             TRACE("dyn_ack", tout << mk_pp(n1, m) << "\n" << mk_pp(n2, m) << "\n"
-                  << mk_pp(r, m) << "\n" << "\nnum_occs: " << num_occs << "\n";);
-            num_occs++;
+                  << mk_pp(r, m) << "\n" << "\nnum_occs: " << o.m_count << "\n";);
+            o.m_count++;
         }
         else {
-            num_occs = 1;
+            if (!promote(m_triple.m_sketch, combine_hash(hash_u_u(n1->get_id(), n2->get_id()), r->get_id()), o.m_count))
+                return;
+            is_new = true;
             m.inc_ref(n1);
             m.inc_ref(n2);
             m.inc_ref(r);
             m_triple.m_apps.push_back(tr);
         }
-        SASSERT(num_occs > 0);
-        m_triple.m_app2num_occs.insert(n1, n2, r, num_occs);
-#ifdef Z3DEBUG
-        unsigned num_occs2 = 0;
-        SASSERT(m_triple.m_app2num_occs.find(n1, n2, r, num_occs2) && num_occs == num_occs2);
-#endif
-        if (num_occs == m_params.m_dack_threshold) {
+        SASSERT(o.m_count > 0);
+        o.m_stamp = m_stamp++;
+        m_triple.m_app2num_occs.insert(n1, n2, r, o);
+        if (o.m_count == m_params.m_dack_threshold) {
             TRACE("dyn_ack", tout << "found candidate:\n" << mk_pp(n1, m) << "\n" << mk_pp(n2, m) 
                   << "\n" << mk_pp(r, m) 
-                  << "\nnum_occs: " << num_occs << "\n";);
+                  << "\nnum_occs: " << o.m_count << "\n";);
             m_triple.m_to_instantiate.push_back(tr);
         }
-        
+        if (is_new && m_params.m_dack_max_pairs > 0 && m_triple.m_app2num_occs.size() > m_triple.m_evict_lim)
+            evict_triples();
     }
 
+    template<typename Occs>
     struct app_pair_lt { 
         typedef std::pair<app *, app *>          app_pair;
-        typedef obj_pair_map<app, app, unsigned> app_pair2num_occs;
+        typedef obj_pair_map<app, app, Occs>     app_pair2num_occs;
         app_pair2num_occs &  m_app_pair2num_occs;
         
         app_pair_lt(app_pair2num_occs & m):
@@ -283,13 +404,12 @@ namespace smt {
         }
         
         bool operator()(app_pair const & p1, app_pair const & p2) const {
-            unsigned n1 = 0;
-            unsigned n2 = 0;
+            Occs n1, n2;
             m_app_pair2num_occs.find(p1.first, p1.second, n1);
             m_app_pair2num_occs.find(p2.first, p2.second, n2);
-            SASSERT(n1 > 0);
-            SASSERT(n2 > 0);
-            return n1 > n2;
+            SASSERT(n1.m_count > 0);
+            SASSERT(n2.m_count > 0);
+            return n1.m_count > n2.m_count;
         }
     };
 
@@ -310,14 +430,14 @@ namespace smt {
                 SASSERT(!m_app_pair2num_occs.contains(p.first, p.second));
                 continue;
             }
-            unsigned num_occs = 0;
-            m_app_pair2num_occs.find(p.first, p.second, num_occs);
+            occs o;
+            m_app_pair2num_occs.find(p.first, p.second, o);
             // The following invariant is not true. p.first and
             // p.second may have been instantiated, and removed from
             // m_app_pair2num_occs, but not from m_app_pairs.
             //
-            // SASSERT(num_occs > 0);
-            num_occs = static_cast<unsigned>(num_occs * m_params.m_dack_gc_inv_decay);
+            // SASSERT(o.m_count > 0);
+            unsigned num_occs = static_cast<unsigned>(o.m_count * m_params.m_dack_gc_inv_decay);
             if (num_occs <= 1) {
                 num_deleted++;
                 TRACE("dyn_ack", tout << "2) erasing:\n" << mk_pp(p.first, m) << "\n" << mk_pp(p.second, m) << "\n";);
@@ -329,12 +449,14 @@ namespace smt {
             *it2 = p;
             ++it2;
             SASSERT(num_occs > 0);
-            m_app_pair2num_occs.insert(p.first, p.second, num_occs);
+            m_app_pair2num_occs.insert(p.first, p.second, occs(num_occs, o.m_stamp));
             if (num_occs >= m_params.m_dack_threshold)
                 m_to_instantiate.push_back(p);
         }
         m_app_pairs.set_end(it2);
-        app_pair_lt f(m_app_pair2num_occs);
+        m_sketch.decay();
+        m_evict_lim = evict_lim(m_app_pair2num_occs.size());
+        app_pair_lt<occs> f(m_app_pair2num_occs);
         // app_pair_lt is not a total order on pairs of expressions.
         // So, we should use stable_sort to avoid different behavior in different platforms.
         std::stable_sort(m_to_instantiate.begin(), m_to_instantiate.end(), f);
@@ -499,9 +621,10 @@ namespace smt {
     }
 
 
+    template<typename Occs>
     struct app_triple_lt { 
         typedef triple<app *, app *, app*>          app_triple;
-        typedef obj_triple_map<app, app, app, unsigned> app_triple2num_occs;
+        typedef obj_triple_map<app, app, app, Occs> app_triple2num_occs;
         app_triple2num_occs &  m_app_triple2num_occs;
         
         app_triple_lt(app_triple2num_occs & m):
@@ -509,13 +632,12 @@ namespace smt {
         }
         
         bool operator()(app_triple const & p1, app_triple const & p2) const {
-            unsigned n1 = 0;
-            unsigned n2 = 0;
+            Occs n1, n2;
             m_app_triple2num_occs.find(p1.first, p1.second, p1.third, n1);
             m_app_triple2num_occs.find(p2.first, p2.second, p2.third, n2);
-            SASSERT(n1 > 0);
-            SASSERT(n2 > 0);
-            return n1 > n2;
+            SASSERT(n1.m_count > 0);
+            SASSERT(n2.m_count > 0);
+            return n1.m_count > n2.m_count;
         }
     };
 
@@ -537,14 +659,14 @@ namespace smt {
                 SASSERT(!m_triple.m_app2num_occs.contains(p.first, p.second, p.third));
                 continue;
             }
-            unsigned num_occs = 0;
-            m_triple.m_app2num_occs.find(p.first, p.second, p.third, num_occs);
+            occs o;
+            m_triple.m_app2num_occs.find(p.first, p.second, p.third, o);
             // The following invariant is not true. p.first and
             // p.second may have been instantiated, and removed from
             // m_app_triple2num_occs, but not from m_app_triples.
             //
-            // SASSERT(num_occs > 0);
-            num_occs = static_cast<unsigned>(num_occs * m_params.m_dack_gc_inv_decay);
+            // SASSERT(o.m_count > 0);
+            unsigned num_occs = static_cast<unsigned>(o.m_count * m_params.m_dack_gc_inv_decay);
             if (num_occs <= 1) {
                 num_deleted++;
                 TRACE("dyn_ack", tout << "2) erasing:\n" << mk_pp(p.first, m) << "\n" << mk_pp(p.second, m) << "\n";);
@@ -557,12 +679,14 @@ namespace smt {
             *it2 = p;
             ++it2;
             SASSERT(num_occs > 0);
-            m_triple.m_app2num_occs.insert(p.first, p.second, p.third, num_occs);
+            m_triple.m_app2num_occs.insert(p.first, p.second, p.third, occs(num_occs, o.m_stamp));
             if (num_occs >= m_params.m_dack_threshold)
                 m_triple.m_to_instantiate.push_back(p);
         }
         m_triple.m_apps.set_end(it2);
-        app_triple_lt f(m_triple.m_app2num_occs);
+        m_triple.m_sketch.decay();
+        m_triple.m_evict_lim = evict_lim(m_triple.m_app2num_occs.size());
+        app_triple_lt<occs> f(m_triple.m_app2num_occs);
         // app_triple_lt is not a total order
         std::stable_sort(m_triple.m_to_instantiate.begin(), m_triple.m_to_instantiate.end(), f);
         // IF_VERBOSE(10, if (num_deleted > 0) verbose_stream() << "dynamic ackermann GC: " << num_deleted << "\n";);
@@ -23,6 +23,7 @@ Revision History:
 #include "util/obj_hashtable.h"
 #include "util/obj_pair_hashtable.h"
 #include "util/obj_triple_hashtable.h"
+#include "util/count_min_sketch.h"
 #include "smt/smt_clause.h"
 
 namespace smt {
@@ -30,14 +31,24 @@ namespace smt {
     class context;
 
     class dyn_ack_manager {
+        /**
+           \brief number of uses of a pair (triple), and the time of its last use.
+        */
+        struct occs {
+            unsigned m_count;
+            uint64_t m_stamp;
+            occs():m_count(0), m_stamp(0) {}
+            occs(unsigned c, uint64_t s):m_count(c), m_stamp(s) {}
+        };
+
         typedef std::pair<app *, app *>           app_pair;
-        typedef obj_pair_map<app, app, unsigned>  app_pair2num_occs;
+        typedef obj_pair_map<app, app, occs>      app_pair2num_occs;
         typedef svector<app_pair>                 app_pair_vector;
         typedef obj_pair_hashtable<app, app>      app_pair_set;
         typedef obj_map<clause, app_pair>         clause2app_pair;
 
         typedef triple<app *, app *,app *>        app_triple;
-        typedef obj_triple_map<app, app, app, unsigned>  app_triple2num_occs;
+        typedef obj_triple_map<app, app, app, occs>  app_triple2num_occs;
         typedef svector<app_triple>                 app_triple_vector;
         typedef obj_triple_hashtable<app, app, app>      app_triple_set;
         typedef obj_map<clause, app_triple>         clause2app_triple;
@@ -53,6 +64,12 @@ namespace smt {
         unsigned                                   m_num_propagations_since_last_gc;
         app_pair_set                               m_instantiated;
         clause2app_pair                            m_clause2app_pair;
+        // When m_dack_max_pairs is non-zero, uses are first counted in a sketch,
+        // and pairs are only tracked exactly after m_dack_promote uses.
+        count_min_sketch                           m_sketch;
+        uint64_t                                   m_stamp;
+        // number of tracked pairs above which pairs are evicted.
+        unsigned                                   m_evict_lim;
 
         struct _triple {
             app_triple2num_occs                    m_app2num_occs;
@@ -63,6 +80,8 @@ namespace smt {
             unsigned                               m_num_propagations_since_last_gc;
             app_triple_set                         m_instantiated;
             clause2app_triple                      m_clause2apps;
+            count_min_sketch                       m_sketch;
+            unsigned                               m_evict_lim;
         };
         _triple                                    m_triple;
         
@@ -80,6 +99,12 @@ namespace smt {
         void instantiate(app * n1, app * n2, app* r);
         void reset_app_triples();
         void gc_triples();
+
+        bool promote(count_min_sketch & sketch, unsigned h, unsigned & num_occs);
+        uint64_t evict_stamp(svector<uint64_t> & stamps);
+        unsigned evict_lim(unsigned num_remaining) const;
+        void evict_pairs();
+        void evict_triples();
         
     public:
         dyn_ack_manager(context & ctx, dyn_ack_params & p);
@@ -19,6 +19,7 @@ Revision History:
 #include <algorithm>
 
 #include "util/pool.h"
+#include "util/obj_pair_hashtable.h"
 #include "util/trail.h"
 #include "util/stopwatch.h"
 #include "ast/ast_pp.h"
@@ -2910,8 +2911,10 @@ namespace {
            - mp: is used a pattern for qa.
 
            - first_idx: index to be used as head of the multi-pattern mp
+
+           Return true if a new code tree was created for the pattern.
         */
-        void add_pattern(quantifier * qa, app * mp, unsigned first_idx) {
+        bool add_pattern(quantifier * qa, app * mp, unsigned first_idx) {
             (void)m;
             SASSERT(m.is_pattern(mp));
             SASSERT(first_idx < mp->get_num_args());
@@ -2919,7 +2922,8 @@ namespace {
             func_decl * lbl   = p->get_decl();
             unsigned lbl_id   = lbl->get_decl_id();
             m_trees.reserve(lbl_id+1, nullptr);
-            if (m_trees[lbl_id] == nullptr) {
+            bool is_new = m_trees[lbl_id] == nullptr;
+            if (is_new) {
                 m_trees[lbl_id] = m_compiler.mk_tree(qa, mp, first_idx, false);
                 SASSERT(m_trees[lbl_id]->expected_num_args() == p->get_num_args());
                 DEBUG_CODE(m_trees[lbl_id]->set_context(m_context););
@@ -2938,6 +2942,7 @@ namespace {
             DEBUG_CODE(m_trees[lbl_id]->get_patterns().push_back(mp);
                        m_trail_stack.push(push_back_trail<mam_impl, app*, false>(m_trees[lbl_id]->get_patterns())););
             TRACE("trigger_bug", tout << "after add_pattern, first_idx: " << first_idx << "\n"; m_trees[lbl_id]->display(tout););
+            return is_new;
         }
 
         void reset() {
@@ -3139,6 +3144,29 @@ namespace {
         class add_shared_enode_trail;
         friend class add_shared_enode_trail;
 
+        struct stats {
+            unsigned m_num_trees;
+            unsigned m_num_inserts;
+            unsigned m_num_duplicates;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+        stats                       m_stats;
+        stopwatch                   m_compile_watch;
+
+        // (quantifier, multi-pattern) pairs compiled into the code trees.
+        // A quantifier may list the same multi-pattern more than once, and
+        // inserting it again would only produce duplicate matches.
+        obj_pair_hashtable<quantifier, app> m_compiled;
+
+        class add_compiled_trail : public mam_trail {
+            quantifier * m_qa;
+            app *        m_mp;
+        public:
+            add_compiled_trail(quantifier * qa, app * mp):m_qa(qa), m_mp(mp) {}
+            void undo(mam_impl & m) override { m.m_compiled.erase(std::make_pair(m_qa, m_mp)); }
+        };
+
         class add_shared_enode_trail : public mam_trail {
             enode * m_enode;
         public:
@@ -3844,6 +3872,13 @@ namespace {
             for (unsigned i = 0; i < num_patterns; i++)
                 if (is_ground(mp->get_arg(i)))
                     return; // ignore multi-pattern containing ground pattern.
+            if (m_compiled.contains(std::make_pair(qa, mp))) {
+                m_stats.m_num_duplicates++;
+                return;
+            }
+            m_compiled.insert(std::make_pair(qa, mp));
+            m_trail_stack.push(add_compiled_trail(qa, mp));
+            scoped_watch _sw(m_compile_watch);
             update_filters(qa, mp);
             collect_ground_exprs(qa, mp);
             m_new_patterns.push_back(qp_pair(qa, mp));
@@ -3851,8 +3886,19 @@ namespace {
             // e-matching. So, for a multi-pattern [ p_1, ..., p_n ],
             // we have to make n insertions. In the i-th insertion,
             // the pattern p_i is assumed to be the first one.
-            for (unsigned i = 0; i < num_patterns; i++)
-                m_trees.add_pattern(qa, mp, i);
+            for (unsigned i = 0; i < num_patterns; i++) {
+                if (m_trees.add_pattern(qa, mp, i))
+                    m_stats.m_num_trees++;
+                else
+                    m_stats.m_num_inserts++;
+            }
+        }
+
+        void collect_statistics(::statistics & st) const override {
+            st.update("mam code trees", m_stats.m_num_trees);
+            st.update("mam pattern inserts", m_stats.m_num_inserts);
+            st.update("mam duplicate patterns", m_stats.m_num_duplicates);
+            st.update("mam compile time", m_compile_watch.get_seconds());
         }
 
         void push_scope() override {
@@ -3873,6 +3919,7 @@ namespace {
         void reset() override {
             m_trail_stack.reset();
             m_trees.reset();
+            m_compiled.reset();
             m_to_match.reset();
             m_new_patterns.reset();
             m_is_plbl.reset();
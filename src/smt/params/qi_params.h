@@ -36,6 +36,7 @@ struct qi_params {
     unsigned           m_qi_max_lazy_multipattern_matching;
     bool               m_qi_profile;
     unsigned           m_qi_profile_freq;
+    std::string        m_qi_profile_json;
     quick_checker_mode m_qi_quick_checker;
     bool               m_qi_lazy_quick_checker;
     bool               m_qi_promote_unsat;
@@ -41,8 +41,11 @@ void smt_params::updt_local_params(params_ref const & _p) {
     m_preprocess = _p.get_bool("preprocess", true); // hidden parameter
     m_max_conflicts = p.max_conflicts();
     m_restart_max   = p.restart_max();
+    m_keep_terms    = p.keep_terms();
     m_threads       = p.threads();
     m_threads_max_conflicts  = p.threads_max_conflicts();
+    m_threads_share_size     = p.threads_share_size();
+    m_threads_share_glue     = p.threads_share_glue();
     m_core_validate = p.core_validate();
     m_logic = _p.get_sym("logic", m_logic);
     m_string_solver = p.string_solver();
@@ -107,6 +110,9 @@ void smt_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_max_conflicts);
     DISPLAY_PARAM(m_threads);
     DISPLAY_PARAM(m_threads_max_conflicts);
+    DISPLAY_PARAM(m_keep_terms);
+    DISPLAY_PARAM(m_threads_share_size);
+    DISPLAY_PARAM(m_threads_share_glue);
     DISPLAY_PARAM(m_simplify_clauses);
     DISPLAY_PARAM(m_tick);
     DISPLAY_PARAM(m_display_features);
@@ -102,8 +102,11 @@ struct smt_params : public preprocessor_params,
     bool             m_minimize_lemmas;
     unsigned         m_max_conflicts;
     unsigned         m_restart_max;
+    unsigned         m_keep_terms;
     unsigned         m_threads;
     unsigned         m_threads_max_conflicts;
+    unsigned         m_threads_share_size;
+    unsigned         m_threads_share_glue;
     bool             m_simplify_clauses;
     unsigned         m_tick;
     bool             m_display_features;
@@ -255,8 +258,11 @@ struct smt_params : public preprocessor_params,
         m_phase_caching_off(100),
         m_minimize_lemmas(true),
         m_max_conflicts(UINT_MAX),
+        m_keep_terms(0),
         m_threads(1),
         m_threads_max_conflicts(UINT_MAX),
+        m_threads_share_size(8),
+        m_threads_share_glue(4),
         m_simplify_clauses(true),
         m_tick(1000),
         m_display_features(false),
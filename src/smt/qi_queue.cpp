@@ -16,6 +16,9 @@ Author:
 Revision History:
 
 --*/
+#include <atomic>
+#include <fstream>
+#include <string>
 #include "util/warning.h"
 #include "util/stats.h"
 #include "ast/ast_pp.h"
@@ -40,9 +43,31 @@ namespace smt {
         m_instances(m) {
         init_parser_vars();
         m_vals.resize(15, 0.0f);
+        if (m_params.m_qi_profile)
+            m_profile = alloc(qi_profile, m);
+    }
+
+    /**
+       \brief each context that recorded instances writes its own profile.
+       The first file uses the given name and the following ones get a sequence
+       number appended, such that contexts of the same process, e.g., parallel
+       workers, do not overwrite each other.
+    */
+    static std::string profile_json_file(std::string const & name) {
+        static std::atomic<unsigned> s_num_files(0);
+        unsigned n = s_num_files++;
+        return n == 0 ? name : name + "." + std::to_string(n);
     }
 
     qi_queue::~qi_queue() {
+        if (m_profile && !m_profile->empty() && !m_params.m_qi_profile_json.empty()) {
+            std::string file = profile_json_file(m_params.m_qi_profile_json);
+            std::ofstream out(file);
+            if (out)
+                display_profile_json(out);
+            else
+                warning_msg("could not open file '%s' for the quantifier instantiation profile", file.c_str());
+        }
     }
 
     void qi_queue::setup() {
@@ -144,6 +169,8 @@ namespace smt {
               }
               tout << "\n";);
         TRACE("new_entries_bug", tout << "[qi:insert]\n";);
+        if (m_profile)
+            m_profile->add_match(q, pat);
         m_new_entries.push_back(entry(f, cost, generation));
     }
 
@@ -200,6 +227,7 @@ namespace smt {
         enode * const * bindings = f->get_args();
 
         ent.m_instantiated = true;
+        qi_profile::scoped_time _st(m_profile.get(), q);
 
         TRACE("qi_queue_profile", tout << q->get_qid() << ", gen: " << generation << " " << *f << " cost: " << ent.m_cost << "\n";);
         // NEVER remove coming_from_quant
@@ -297,10 +325,13 @@ namespace smt {
         m_stats.m_num_instances++;
         unsigned gen = get_new_gen(q, generation, ent.m_cost);
         display_instance_profile(f, q, num_bindings, bindings, proof_id, gen);
+        unsigned num_enodes = m_context.enodes().size();
         m_context.internalize_instance(lemma, pr1, gen);
         if (f->get_def()) {
             m_context.internalize(f->get_def(), true);
         }
+        if (m_profile)
+            m_profile->add_instance(q, num_bindings, bindings, gen, m_context.enodes(), num_enodes);
         TRACE_CODE({
             static unsigned num_useless = 0;
             if (m.is_or(lemma)) {
@@ -481,6 +512,8 @@ namespace smt {
         get_min_max_costs(min, max);
         st.update("min missed qa cost", min);
         st.update("max missed qa cost", max);
+        if (m_profile)
+            m_profile->collect_statistics(st);
 #if 0
         if (m_params.m_qi_profile) {
             out << "missed/delayed quantifier instances:\n";
@@ -489,5 +522,10 @@ namespace smt {
 #endif
     }
 
+    void qi_queue::display_profile_json(std::ostream & out) const {
+        if (m_profile)
+            m_profile->display_json(out);
+    }
+
 };
 
@@ -27,6 +27,7 @@ Revision History:
 #include "parsers/util/cost_parser.h"
 #include "smt/cost_evaluator.h"
 #include "smt/cached_var_subst.h"
+#include "smt/smt_qi_profile.h"
 #include "util/statistics.h"
 
 namespace smt {
@@ -69,6 +70,7 @@ namespace smt {
             unsigned   m_instantiated_trail_lim;
         };
         svector<scope>                m_scopes;
+        scoped_ptr<qi_profile>        m_profile;    // created if qi.profile is set
 
         void init_parser_vars();
         quantifier_stat * set_values(quantifier * q, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation, float cost);
@@ -96,6 +98,7 @@ namespace smt {
         void reset();
         void display_delayed_instances_stats(std::ostream & out) const;
         void collect_statistics(::statistics & st) const;
+        void display_profile_json(std::ostream & out) const;
     };
 };
 
@@ -51,8 +51,11 @@ namespace smt {
         return c;
     }
 
-    bool cg_table::cg_eq::operator()(enode * n1, enode * n2) const {
+    bool cg_table::cg_eq::operator()(cg_entry const & e1, cg_entry const & e2) const {
+        enode * n1 = e1.m_node, * n2 = e2.m_node;
         SASSERT(n1->get_decl() == n2->get_decl());
+        if (e1.m_hash != e2.m_hash)
+            return false;
         unsigned num = n1->get_num_args();
         if (num != n2->get_num_args()) {
             return false;
@@ -87,7 +90,7 @@ namespace smt {
                 return r;
             }
             else if (d->is_commutative()) {
-                r = TAG(void*, alloc(comm_table, cg_comm_hash(), cg_comm_eq(m_commutativity)), BINARY_COMM);
+                r = TAG(void*, alloc(comm_table, cg_entry_hash(), cg_comm_eq(m_commutativity)), BINARY_COMM);
                 SASSERT(GET_TAG(r) == BINARY_COMM);
                 return r;
             }
@@ -170,8 +173,8 @@ namespace smt {
     void cg_table::display_binary(std::ostream& out, void* t) const {
         binary_table* tb = UNTAG(binary_table*, t);
         out << "b ";
-        for (enode* n : *tb) {
-            out << n->get_owner_id() << " " << cg_binary_hash()(n) << " ";
+        for (cg_entry const& e : *tb) {
+            out << e.m_node->get_owner_id() << " " << e.m_hash << " ";
         }
         out << "\n";
     }
@@ -179,8 +182,8 @@ namespace smt {
     void cg_table::display_binary_comm(std::ostream& out, void* t) const {
         comm_table* tb = UNTAG(comm_table*, t);
         out << "bc ";
-        for (enode* n : *tb) {
-            out << n->get_owner_id() << " ";
+        for (cg_entry const& e : *tb) {
+            out << e.m_node->get_owner_id() << " ";
         }
         out << "\n";
     }
@@ -188,8 +191,8 @@ namespace smt {
     void cg_table::display_unary(std::ostream& out, void* t) const {
         unary_table* tb = UNTAG(unary_table*, t);
         out << "un ";
-        for (enode* n : *tb) {
-            out << n->get_owner_id() << " ";
+        for (cg_entry const& e : *tb) {
+            out << e.m_node->get_owner_id() << " ";
         }
         out << "\n";
     }
@@ -197,8 +200,8 @@ namespace smt {
     void cg_table::display_nary(std::ostream& out, void* t) const {
         table* tb = UNTAG(table*, t);
         out << "nary ";
-        for (enode* n : *tb) {
-            out << n->get_owner_id() << " ";
+        for (cg_entry const& e : *tb) {
+            out << e.m_node->get_owner_id() << " ";
         }
         out << "\n";
     }
@@ -213,19 +216,19 @@ namespace smt {
         void * t = get_table(n); 
         switch (static_cast<table_kind>(GET_TAG(t))) {
         case UNARY:
-            n_prime = UNTAG(unary_table*, t)->insert_if_not_there(n);
+            n_prime = UNTAG(unary_table*, t)->insert_if_not_there(cg_entry(n, cg_unary_hash()(n))).m_node;
             return enode_bool_pair(n_prime, false);
         case BINARY:
-            n_prime = UNTAG(binary_table*, t)->insert_if_not_there(n);
+            n_prime = UNTAG(binary_table*, t)->insert_if_not_there(cg_entry(n, cg_binary_hash()(n))).m_node;
             TRACE("cg_table", tout << "insert: " << n->get_owner_id() << " " << cg_binary_hash()(n) << " inserted: " << (n == n_prime) << " " << n_prime->get_owner_id() << "\n";
                   display_binary(tout, t); tout << "contains_ptr: " << contains_ptr(n) << "\n";); 
             return enode_bool_pair(n_prime, false);
         case BINARY_COMM:
             m_commutativity = false;
-            n_prime = UNTAG(comm_table*, t)->insert_if_not_there(n);
+            n_prime = UNTAG(comm_table*, t)->insert_if_not_there(cg_entry(n, cg_comm_hash()(n))).m_node;
             return enode_bool_pair(n_prime, m_commutativity);
         default:
-            n_prime = UNTAG(table*, t)->insert_if_not_there(n);
+            n_prime = UNTAG(table*, t)->insert_if_not_there(cg_entry(n, cg_hash()(n))).m_node;
             return enode_bool_pair(n_prime, false);
         }
     }
@@ -235,17 +238,17 @@ namespace smt {
         void * t = get_table(n); 
         switch (static_cast<table_kind>(GET_TAG(t))) {
         case UNARY:
-            UNTAG(unary_table*, t)->erase(n);
+            UNTAG(unary_table*, t)->erase(cg_entry(n, cg_unary_hash()(n)));
             break;
         case BINARY:
             TRACE("cg_table", tout << "erase: " << n->get_owner_id() << " " << cg_binary_hash()(n) << " contains: " << contains_ptr(n) << "\n";);
-            UNTAG(binary_table*, t)->erase(n);
+            UNTAG(binary_table*, t)->erase(cg_entry(n, cg_binary_hash()(n)));
             break;
         case BINARY_COMM:
-            UNTAG(comm_table*, t)->erase(n);
+            UNTAG(comm_table*, t)->erase(cg_entry(n, cg_comm_hash()(n)));
             break;
         default:
-            UNTAG(table*, t)->erase(n);
+            UNTAG(table*, t)->erase(cg_entry(n, cg_hash()(n)));
             break;
         }
     }
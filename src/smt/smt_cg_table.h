@@ -30,8 +30,25 @@ namespace smt {
 
     /**
        \brief Congruence table.
+
+       Entries store the hash of the argument roots next to the enode.
+       Probes compare the stored hashes before following the argument
+       pointers, and growing a table rehashes entries without touching
+       the enodes. The stored hash is valid because an enode is removed
+       from the table before the roots of its arguments change.
     */
     class cg_table {
+        struct cg_entry {
+            enode *  m_node;
+            unsigned m_hash;
+            cg_entry():m_node(nullptr), m_hash(0) {}
+            cg_entry(enode * n, unsigned h):m_node(n), m_hash(h) {}
+        };
+
+        struct cg_entry_hash {
+            unsigned operator()(cg_entry const & e) const { return e.m_hash; }
+        };
+
         struct cg_unary_hash {
             unsigned operator()(enode * n) const {
                 SASSERT(n->get_num_args() == 1);
@@ -40,15 +57,16 @@ namespace smt {
         };
 
         struct cg_unary_eq {
-            bool operator()(enode * n1, enode * n2) const {
+            bool operator()(cg_entry const & e1, cg_entry const & e2) const {
+                enode * n1 = e1.m_node, * n2 = e2.m_node;
                 SASSERT(n1->get_num_args() == 1);
                 SASSERT(n2->get_num_args() == 1);
                 SASSERT(n1->get_decl() == n2->get_decl());
-                return n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root();
+                return e1.m_hash == e2.m_hash && n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root();
             }
         };
 
-        typedef chashtable<enode *, cg_unary_hash, cg_unary_eq> unary_table;
+        typedef chashtable<cg_entry, cg_entry_hash, cg_unary_eq> unary_table;
         
         struct cg_binary_hash {
             unsigned operator()(enode * n) const {
@@ -58,17 +76,19 @@ namespace smt {
         };
 
         struct cg_binary_eq {
-            bool operator()(enode * n1, enode * n2) const {
+            bool operator()(cg_entry const & e1, cg_entry const & e2) const {
+                enode * n1 = e1.m_node, * n2 = e2.m_node;
                 SASSERT(n1->get_num_args() == 2);
                 SASSERT(n2->get_num_args() == 2);
                 SASSERT(n1->get_decl() == n2->get_decl());
                 return 
+                    e1.m_hash == e2.m_hash &&
                     n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root() &&
                     n1->get_arg(1)->get_root() == n2->get_arg(1)->get_root();
             }
         };
 
-        typedef chashtable<enode*, cg_binary_hash, cg_binary_eq> binary_table;
+        typedef chashtable<cg_entry, cg_entry_hash, cg_binary_eq> binary_table;
         
         struct cg_comm_hash {
             unsigned operator()(enode * n) const {
@@ -84,10 +104,13 @@ namespace smt {
         struct cg_comm_eq {
             bool & m_commutativity;
             cg_comm_eq(bool & c):m_commutativity(c) {}
-            bool operator()(enode * n1, enode * n2) const {
+            bool operator()(cg_entry const & e1, cg_entry const & e2) const {
+                enode * n1 = e1.m_node, * n2 = e2.m_node;
                 SASSERT(n1->get_num_args() == 2);
                 SASSERT(n2->get_num_args() == 2);
                 SASSERT(n1->get_decl() == n2->get_decl());
+                if (e1.m_hash != e2.m_hash)
+                    return false;
                 enode * c1_1 = n1->get_arg(0)->get_root();
                 enode * c1_2 = n1->get_arg(1)->get_root();
                 enode * c2_1 = n2->get_arg(0)->get_root();
@@ -103,17 +126,17 @@ namespace smt {
             }
         };
 
-        typedef chashtable<enode*, cg_comm_hash, cg_comm_eq> comm_table;
+        typedef chashtable<cg_entry, cg_entry_hash, cg_comm_eq> comm_table;
 
         struct cg_hash {
             unsigned operator()(enode * n) const;
         };
 
         struct cg_eq {
-            bool operator()(enode * n1, enode * n2) const;
+            bool operator()(cg_entry const & e1, cg_entry const & e2) const;
         };
 
-        typedef chashtable<enode*, cg_hash, cg_eq> table;
+        typedef chashtable<cg_entry, cg_entry_hash, cg_eq> table;
 
         ast_manager &                 m_manager;
         bool                          m_commutativity; //!< true if the last found congruence used commutativity
@@ -153,50 +176,27 @@ namespace smt {
         void erase(enode * n);
 
         bool contains(enode * n) const {
-            SASSERT(n->get_num_args() > 0);
-            void * t = const_cast<cg_table*>(this)->get_table(n); 
-            switch (static_cast<table_kind>(GET_TAG(t))) {
-            case UNARY:
-                return UNTAG(unary_table*, t)->contains(n);
-            case BINARY:
-                return UNTAG(binary_table*, t)->contains(n);
-            case BINARY_COMM:
-                return UNTAG(comm_table*, t)->contains(n);
-            default:
-                return UNTAG(table*, t)->contains(n);
-            }
+            return find(n) != nullptr;
         }
 
         enode * find(enode * n) const {
             SASSERT(n->get_num_args() > 0);
-            enode * r = nullptr;
+            cg_entry r;
             void * t = const_cast<cg_table*>(this)->get_table(n); 
             switch (static_cast<table_kind>(GET_TAG(t))) {
             case UNARY:
-                return UNTAG(unary_table*, t)->find(n, r) ? r : nullptr;
+                return UNTAG(unary_table*, t)->find(cg_entry(n, cg_unary_hash()(n)), r) ? r.m_node : nullptr;
             case BINARY:
-                return UNTAG(binary_table*, t)->find(n, r) ? r : nullptr;
+                return UNTAG(binary_table*, t)->find(cg_entry(n, cg_binary_hash()(n)), r) ? r.m_node : nullptr;
             case BINARY_COMM:
-                return UNTAG(comm_table*, t)->find(n, r) ? r : nullptr;
+                return UNTAG(comm_table*, t)->find(cg_entry(n, cg_comm_hash()(n)), r) ? r.m_node : nullptr;
             default:
-                return UNTAG(table*, t)->find(n, r) ? r : nullptr;
+                return UNTAG(table*, t)->find(cg_entry(n, cg_hash()(n)), r) ? r.m_node : nullptr;
             }
         }
 
         bool contains_ptr(enode * n) const {
-            enode * r;
-            SASSERT(n->get_num_args() > 0);
-            void * t = const_cast<cg_table*>(this)->get_table(n); 
-            switch (static_cast<table_kind>(GET_TAG(t))) {
-            case UNARY:
-                return UNTAG(unary_table*, t)->find(n, r) && n == r;
-            case BINARY:
-                return UNTAG(binary_table*, t)->find(n, r) && n == r;
-            case BINARY_COMM:
-                return UNTAG(comm_table*, t)->find(n, r) && n == r;
-            default:
-                return UNTAG(table*, t)->find(n, r) && n == r;
-            }
+            return find(n) == n;
         }
 
         void reset();
@@ -48,7 +48,9 @@ namespace smt {
         m_watches(watches),
         m_new_proofs(m),
         m_trail(m),
-        m_lemma_proof(m)
+        m_lemma_proof(m),
+        m_min_visit_id(0),
+        m_min_uses_lemma(false)
     {
     }
 
@@ -639,19 +641,54 @@ namespace smt {
     bool conflict_resolution::process_antecedent_for_minimization(literal antecedent) {
         bool_var var = antecedent.var();
         unsigned lvl = m_ctx.get_assign_level(var);
-        if (!m_ctx.is_marked(var) && lvl > m_ctx.get_base_level()) {
-            if (m_lvl_set.may_contain(lvl)) {
-                m_ctx.set_mark(var);
-                m_unmark.push_back(var);
-                m_lemma_min_stack.push_back(var);
-            }
-            else {
-                return false;
-            }
+        if (lvl <= m_ctx.get_base_level())
+            return true;
+        if (is_min_redundant(var)) {
+            m_ctx.m_stats.m_num_minimize_cache_hits++;
+            return true;
         }
+        if (m_ctx.is_marked(var)) {
+            // var is in the lemma or it was shown to be implied by the lemma.
+            if (static_cast<unsigned>(var) >= m_min_visit.size() || m_min_visit[var] != m_min_visit_id)
+                m_min_uses_lemma = true;
+            return true;
+        }
+        if (is_min_failed(var) || !m_lvl_set.may_contain(lvl))
+            return false;
+        m_ctx.set_mark(var);
+        m_unmark.push_back(var);
+        m_lemma_min_stack.push_back(var);
+        m_min_visit.reserve(var + 1, 0);
+        m_min_visit[var] = m_min_visit_id;
         return true;
     }
 
+    void conflict_resolution::set_min_redundant(bool_var v) {
+        if (is_min_redundant(v))
+            return;
+        unsigned lvl = m_ctx.get_assign_level(v);
+        m_min_redundant.reserve(v + 1, false);
+        m_min_redundant[v] = true;
+        m_min_redundant_at.reserve(lvl + 1);
+        m_min_redundant_at[lvl].push_back(v);
+    }
+
+    void conflict_resolution::set_min_failed(bool_var v) {
+        if (is_min_failed(v))
+            return;
+        m_min_failed.reserve(v + 1, false);
+        m_min_failed[v] = true;
+        m_min_failed_vars.push_back(v);
+    }
+
+    void conflict_resolution::pop_scope(unsigned new_lvl) {
+        for (unsigned lvl = new_lvl + 1; lvl < m_min_redundant_at.size(); ++lvl) {
+            for (bool_var v : m_min_redundant_at[lvl])
+                m_min_redundant[v] = false;
+            m_min_redundant_at[lvl].reset();
+        }
+    }
+
     bool conflict_resolution::process_justification_for_minimization(justification * js) {
         literal_vector & antecedents = m_tmp_literal_vector;
         antecedents.reset();
@@ -677,6 +714,11 @@ namespace smt {
         m_lemma_min_stack.push_back(lit.var());
         unsigned old_size     = m_unmark.size();
         unsigned old_js_qhead = m_todo_js_qhead;
+        if (++m_min_visit_id == 0) {
+            m_min_visit.reset();
+            m_min_visit_id = 1;
+        }
+        m_min_uses_lemma = false;
 
         while (!m_lemma_min_stack.empty()) {
             bool_var var       = m_lemma_min_stack.back();
@@ -693,42 +735,55 @@ namespace smt {
                         literal l = (*cls)[i];
                         SASSERT(l.var() != var);
                         if (!process_antecedent_for_minimization(~l)) {
-                            reset_unmark_and_justifications(old_size, old_js_qhead);
-                            return false;
+                            return minimization_failed(var, lit, old_size, old_js_qhead);
                         }
                     }
                 }
                 justification * js = cls->get_justification();
                 if (js && !process_justification_for_minimization(js)) {
-                    reset_unmark_and_justifications(old_size, old_js_qhead);
-                    return false;
+                    return minimization_failed(var, lit, old_size, old_js_qhead);
                 }
                 break;
             }
             case b_justification::BIN_CLAUSE:
                 if (!process_antecedent_for_minimization(js.get_literal())) {
-                    reset_unmark_and_justifications(old_size, old_js_qhead);
-                    return false;
+                    return minimization_failed(var, lit, old_size, old_js_qhead);
                 }
                 break;
             case b_justification::AXIOM:
                 // it is a decision variable from a previous scope level or an assumption
                 if (m_ctx.get_assign_level(var) > m_ctx.get_base_level()) {
-                    reset_unmark_and_justifications(old_size, old_js_qhead);
-                    return false;
+                    return minimization_failed(var, lit, old_size, old_js_qhead);
                 }
                 break;
             case b_justification::JUSTIFICATION:
                 if (m_ctx.is_assumption(var) || !process_justification_for_minimization(js.get_justification())) {
-                    reset_unmark_and_justifications(old_size, old_js_qhead);
-                    return false;
+                    return minimization_failed(var, lit, old_size, old_js_qhead);
                 }
                 break;
             }
         }
+        if (!m_min_uses_lemma && !m.proofs_enabled()) {
+            // the variables visited by the search are implied by the base level.
+            set_min_redundant(lit.var());
+            for (unsigned i = old_size; i < m_unmark.size(); ++i)
+                set_min_redundant(m_unmark[i]);
+        }
         return true;
     }
 
+    /**
+       \brief The search for lit failed at var. Both var and lit are not
+       implied by marked literals for the rest of the current minimization,
+       since marks are only added for literals at levels of the lemma.
+    */
+    bool conflict_resolution::minimization_failed(bool_var var, literal lit, unsigned old_size, unsigned old_js_qhead) {
+        reset_unmark_and_justifications(old_size, old_js_qhead);
+        set_min_failed(var);
+        set_min_failed(lit.var());
+        return false;
+    }
+
     /**
        \brief Minimize the number of literals in learned_clause_lits. The main idea is to remove
        literals that are implied by other literals in m_lemma and/or literals
@@ -757,6 +812,9 @@ namespace smt {
         }
 
         reset_unmark_and_justifications(0, 0);
+        for (bool_var v : m_min_failed_vars)
+            m_min_failed[v] = false;
+        m_min_failed_vars.reset();
         m_lemma      .shrink(j);
         m_lemma_atoms.shrink(j);
         m_ctx.m_stats.m_num_minimized_lits += sz - j;
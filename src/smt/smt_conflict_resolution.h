@@ -117,6 +117,9 @@ namespace smt {
                 js->set_mark();
                 m_todo_js.push_back(js);
             }
+            else {
+                m_min_uses_lemma = true;
+            }
         }
 
         void mark_eq(enode * n1, enode * n2) {
@@ -130,6 +133,9 @@ namespace smt {
                     m_todo_eqs.push_back(p);
                     SASSERT(m_already_processed_eqs.contains(p));
                 }
+                else {
+                    m_min_uses_lemma = true;
+                }
             }
         }
 
@@ -188,8 +194,27 @@ namespace smt {
         bool process_antecedent_for_minimization(literal antecedent);
         bool process_justification_for_minimization(justification * js);
         bool implied_by_marked(literal lit);
+        bool minimization_failed(bool_var var, literal lit, unsigned old_size, unsigned old_js_qhead);
         void minimize_lemma();
 
+        // Redundancy cache for lemma minimization.
+        // A variable is redundant if it is implied by literals assigned at the base level,
+        // without using literals of the lemma. Redundant variables stay valid across
+        // conflicts until their assignment level is backtracked, and they are kept
+        // in buckets indexed by that level.
+        // Variables that cannot be removed are cached for the duration of a single minimization.
+        bool_vector             m_min_redundant;
+        vector<bool_var_vector> m_min_redundant_at;
+        bool_vector             m_min_failed;
+        bool_var_vector         m_min_failed_vars;
+        unsigned_vector         m_min_visit;      // variable -> search that marked it
+        unsigned                m_min_visit_id;
+        bool                    m_min_uses_lemma; // the search used marks or antecedents that may depend on the lemma
+        bool is_min_redundant(bool_var v) const { return static_cast<unsigned>(v) < m_min_redundant.size() && m_min_redundant[v]; }
+        bool is_min_failed(bool_var v) const { return static_cast<unsigned>(v) < m_min_failed.size() && m_min_failed[v]; }
+        void set_min_redundant(bool_var v);
+        void set_min_failed(bool_var v);
+
         void structural_minimization();
 
         void process_antecedent_for_unsat_core(literal antecedent);
@@ -258,6 +283,11 @@ namespace smt {
 
         void justification2literals(justification * js, literal_vector & result);
 
+        /**
+           \brief Invalidate cached minimization results for variables assigned above new_lvl.
+        */
+        void pop_scope(unsigned new_lvl);
+
         void eq2literals(enode * n1, enode * n2, literal_vector & result);
 
     };
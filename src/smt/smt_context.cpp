@@ -64,6 +64,9 @@ namespace smt {
         m_b_internalized_stack(m),
         m_e_internalized_stack(m),
         m_l_internalized_stack(m),
+        m_popped_terms_pin(m),
+        m_kept_terms(m),
+        m_num_live_kept_terms(0),
         m_final_check_idx(0),
         m_is_auxiliary(false),
         m_par(nullptr),
@@ -133,51 +136,72 @@ namespace smt {
     }
 
     void context::copy(context& src_ctx, context& dst_ctx, bool override_base) {
-        ast_manager& dst_m = dst_ctx.get_manager();
         ast_manager& src_m = src_ctx.get_manager();
-        src_ctx.pop_to_base_lvl();
+        expr_ref_vector fmls(src_m), units(src_m);
+        proof_ref_vector prs(src_m);
+        src_ctx.collect_copy(override_base, fmls, prs, units);
+        copy_setup(src_ctx, dst_ctx);
+        copy_assertions(src_ctx, dst_ctx, fmls, prs, units);
+    }
 
-        if (!override_base && src_ctx.m_base_lvl > 0) {
+    void context::collect_copy(bool override_base, expr_ref_vector& fmls, proof_ref_vector& prs, expr_ref_vector& units) {
+        pop_to_base_lvl();
+
+        if (!override_base && m_base_lvl > 0) {
             throw default_exception("Cloning contexts within a user-scope is not allowed");
         }
-        SASSERT(src_ctx.m_base_lvl == 0 || override_base);
+        SASSERT(m_base_lvl == 0 || override_base);
 
-        ast_translation tr(src_m, dst_m, false);
+        for (unsigned i = 0; i < m_asserted_formulas.get_num_formulas(); ++i) {
+            fmls.push_back(m_asserted_formulas.get_formula(i));
+            prs.push_back(m_asserted_formulas.get_formula_proof(i));
+        }
+
+        if (!m_setup.already_configured()) {
+            return;
+        }
 
+        for (unsigned i = 0; !m.proofs_enabled() && i < m_assigned_literals.size(); ++i) {
+            literal lit = m_assigned_literals[i];
+            bool_var_data const & d = get_bdata(lit.var());
+            if (d.is_theory_atom() && !m_theories.get_plugin(d.get_theory())->is_safe_to_copy(lit.var())) {
+                continue;
+            }
+            expr_ref fml(m);
+            literal2expr(lit, fml);
+            units.push_back(fml);
+        }
+    }
+
+    void context::copy_setup(context& src_ctx, context& dst_ctx) {
         dst_ctx.set_logic(src_ctx.m_setup.get_logic());
         dst_ctx.copy_plugins(src_ctx, dst_ctx);
+        src_ctx.m_asserted_formulas.get_macro_manager().copy_to(dst_ctx.m_asserted_formulas.get_macro_manager());
+    }
 
-        asserted_formulas& src_af = src_ctx.m_asserted_formulas;
+    void context::copy_assertions(context& src_ctx, context& dst_ctx, 
+                                  expr_ref_vector const& fmls, proof_ref_vector const& prs, expr_ref_vector const& units) {
+        ast_manager& dst_m = dst_ctx.get_manager();
+        ast_translation tr(src_ctx.get_manager(), dst_m, false);
         asserted_formulas& dst_af = dst_ctx.m_asserted_formulas;
 
-        // Copy asserted formulas.
-        for (unsigned i = 0; i < src_af.get_num_formulas(); ++i) {
+        for (unsigned i = 0; i < fmls.size(); ++i) {
             expr_ref fml(dst_m);
             proof_ref pr(dst_m);
-            proof* pr_src = src_af.get_formula_proof(i);
-            fml = tr(src_af.get_formula(i));
-            if (pr_src) {
-                pr = tr(pr_src);
+            fml = tr(fmls[i]);
+            if (prs[i]) {
+                pr = tr(prs[i]);
             }
             dst_af.assert_expr(fml, pr);
         }
 
-        src_af.get_macro_manager().copy_to(dst_af.get_macro_manager());
-
         if (!src_ctx.m_setup.already_configured()) {
             return;
         }
 
-        for (unsigned i = 0; !src_m.proofs_enabled() && i < src_ctx.m_assigned_literals.size(); ++i) {
-            literal lit = src_ctx.m_assigned_literals[i];
-            bool_var_data const & d = src_ctx.get_bdata(lit.var());
-            if (d.is_theory_atom() && !src_ctx.m_theories.get_plugin(d.get_theory())->is_safe_to_copy(lit.var())) {
-                continue;
-            }
-            expr_ref fml0(src_m), fml1(dst_m);
-            src_ctx.literal2expr(lit, fml0);
-            fml1 = tr(fml0.get());
-            dst_ctx.assert_expr(fml1);
+        for (expr* u : units) {
+            expr_ref fml(tr(u), dst_m);
+            dst_ctx.assert_expr(fml);
         }
 
         dst_ctx.setup_context(dst_ctx.m_fparams.m_auto_config);
@@ -2434,6 +2458,7 @@ namespace smt {
             m_atom_propagation_queue.reset();
             m_region.pop_scope(num_scopes);
             m_scopes.shrink(new_lvl);
+            m_conflict_resolution->pop_scope(new_lvl);
             m_conflict_resolution->reset();
 
             m_scope_lvl = new_lvl;
@@ -2891,6 +2916,9 @@ namespace smt {
         bs.m_lemmas_lim = m_lemmas.size();
         bs.m_inconsistent = inconsistent();
         bs.m_simp_qhead_lim = m_simp_qhead;
+        bs.m_b_internalized_lim = m_b_internalized_stack.size();
+        bs.m_e_internalized_lim = m_e_internalized_stack.size();
+        bs.m_kept_terms_lim = m_num_live_kept_terms;
         m_base_lvl++;
         m_search_lvl++; // Not really necessary. But, it is useful to enforce the invariant m_search_lvl >= m_base_lvl
         SASSERT(m_base_lvl <= m_scope_lvl);
@@ -2899,8 +2927,74 @@ namespace smt {
     void context::pop(unsigned num_scopes) {
         SASSERT (num_scopes > 0);
         if (num_scopes > m_scope_lvl) return;
+        if (m_fparams.m_keep_terms > 0)
+            collect_kept_terms(num_scopes);
         pop_to_base_lvl();
         pop_scope(num_scopes);
+        internalize_kept_terms();
+    }
+
+    /**
+       \brief Count the terms internalized in the user scopes that are about to be popped.
+       Terms used in at least two popped scopes are scheduled to be internalized again
+       after the pop, such that the next push/pop cycle over the same terms does not
+       pay for internalization. Relevancy is used to skip terms the last check did not use,
+       so a kept term that is not used again is dropped when its own scope is popped.
+       Kept terms internalized at the base level are never reclaimed, therefore the kept
+       terms of all remaining scopes together are bounded by keep_terms.
+    */
+    void context::collect_kept_terms(unsigned num_scopes) {
+        if (num_scopes > m_base_scopes.size())
+            return;
+        base_scope const & bs = m_base_scopes[m_base_scopes.size() - num_scopes];
+        // kept terms of the popped scopes are released.
+        m_num_live_kept_terms = bs.m_kept_terms_lim;
+        for (unsigned i = bs.m_e_internalized_lim; i < m_e_internalized_stack.size(); ++i)
+            collect_kept_term(m_e_internalized_stack.get(i), false);
+        for (unsigned i = bs.m_b_internalized_lim; i < m_b_internalized_stack.size(); ++i)
+            collect_kept_term(m_b_internalized_stack.get(i), true);
+        if (m_popped_terms.size() / 16 > m_fparams.m_keep_terms)
+            decay_popped_terms();
+    }
+
+    void context::collect_kept_term(expr * n, bool gate_ctx) {
+        if (!is_app(n) || !is_ground(n) || ::has_quantifiers(n) || !is_relevant(n))
+            return;
+        unsigned count = 0;
+        if (!m_popped_terms.find(n, count))
+            m_popped_terms_pin.push_back(n);
+        m_popped_terms.insert(n, ++count);
+        if (count >= 2 && m_num_live_kept_terms + m_kept_terms.size() < m_fparams.m_keep_terms) {
+            m_kept_terms.push_back(n);
+            m_kept_terms_gate.push_back(gate_ctx);
+        }
+    }
+
+    void context::decay_popped_terms() {
+        expr_ref_vector pin(m);
+        obj_map<expr, unsigned> popped_terms;
+        for (auto const & kv : m_popped_terms) {
+            if (kv.m_value > 1) {
+                pin.push_back(kv.m_key);
+                popped_terms.insert(kv.m_key, kv.m_value / 2);
+            }
+        }
+        m_popped_terms.swap(popped_terms);
+        m_popped_terms_pin.swap(pin);
+    }
+
+    void context::internalize_kept_terms() {
+        for (unsigned i = 0; i < m_kept_terms.size() && !inconsistent(); ++i) {
+            expr * n = m_kept_terms.get(i);
+            bool gate_ctx = m_kept_terms_gate[i];
+            if (gate_ctx ? b_internalized(n) : e_internalized(n))
+                continue;
+            internalize(n, gate_ctx);
+            m_num_live_kept_terms++;
+            m_stats.m_num_kept_terms++;
+        }
+        m_kept_terms.reset();
+        m_kept_terms_gate.reset();
     }
 
     /**
@@ -3714,6 +3808,8 @@ namespace smt {
                 pop_scope(m_scope_lvl - curr_lvl);
                 SASSERT(at_search_level());
             }
+            if (m_par && !inconsistent()) 
+                m_par->import_lemmas(*this);
             for (theory* th : m_theory_set) {
                 if (!inconsistent()) th->restart_eh();
             }
@@ -4146,6 +4242,8 @@ namespace smt {
             }
 #endif
             mk_clause(num_lits, lits, js, CLS_LEARNED);
+            if (m_par) 
+                m_par->share_lemma(*this, num_lits, lits);
             if (delay_forced_restart) {
                 SASSERT(num_lits == 1);
                 expr * unit     = bool_var2expr(lits[0].var());
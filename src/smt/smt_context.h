@@ -108,6 +108,17 @@ namespace smt {
         expr_ref_vector             m_e_internalized_stack; // stack of the expressions already internalized as enodes.
         quantifier_ref_vector       m_l_internalized_stack;
 
+        // Terms used in popped user scopes are counted in m_popped_terms.
+        // Terms that were used repeatedly are internalized again after pop,
+        // see keep_terms. The counts are halved when the table grows too large.
+        // m_num_live_kept_terms is the number of kept terms internalized in the
+        // remaining scopes, it is bounded by keep_terms.
+        obj_map<expr, unsigned>     m_popped_terms;
+        expr_ref_vector             m_popped_terms_pin;
+        expr_ref_vector             m_kept_terms;
+        bool_vector                 m_kept_terms_gate;
+        unsigned                    m_num_live_kept_terms;
+
         ptr_vector<justification>   m_justifications;
 
         unsigned                    m_final_check_idx; // circular counter used for implementing fairness
@@ -633,6 +644,9 @@ namespace smt {
             unsigned                m_lemmas_lim;
             unsigned                m_simp_qhead_lim;
             unsigned                m_inconsistent;
+            unsigned                m_b_internalized_lim;
+            unsigned                m_e_internalized_lim;
+            unsigned                m_kept_terms_lim;
         };
 
         svector<scope>              m_scopes;
@@ -644,6 +658,14 @@ namespace smt {
 
         void pop_scope(unsigned num_scopes);
 
+        void collect_kept_terms(unsigned num_scopes);
+
+        void collect_kept_term(expr * n, bool gate_ctx);
+
+        void decay_popped_terms();
+
+        void internalize_kept_terms();
+
         void undo_trail_stack(unsigned old_size);
 
         void unassign_vars(unsigned old_lim);
@@ -1560,6 +1582,19 @@ namespace smt {
 
         static void copy(context& src, context& dst, bool override_base = false);
 
+        /**
+           \brief copy in phases: collect_copy gathers the assertions and base-level units
+           of this context, copy_setup creates the theories and macros of dst.
+           copy_assertions only reads src and the gathered terms, such that copies into
+           contexts over separate managers can run concurrently when the manager of src is frozen.
+         */
+        void collect_copy(bool override_base, expr_ref_vector& fmls, proof_ref_vector& prs, expr_ref_vector& units);
+
+        static void copy_setup(context& src, context& dst);
+
+        static void copy_assertions(context& src, context& dst,
+                                    expr_ref_vector const& fmls, proof_ref_vector const& prs, expr_ref_vector const& units);
+
         /**
            \brief Translate context to use new manager m.
          */
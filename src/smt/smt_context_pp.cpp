@@ -388,9 +388,13 @@ namespace smt {
         st.update("mk clause", m_stats.m_num_mk_clause);
         st.update("del clause", m_stats.m_num_del_clause);
         st.update("dyn ack", m_stats.m_num_dyn_ack);
+        st.update("dyn ack promotions", m_stats.m_num_dyn_ack_promotions);
+        st.update("dyn ack evictions", m_stats.m_num_dyn_ack_evictions);
         st.update("interface eqs", m_stats.m_num_interface_eqs);
         st.update("max generation", m_stats.m_max_generation);
         st.update("minimized lits", m_stats.m_num_minimized_lits);
+        st.update("minimize cache hits", m_stats.m_num_minimize_cache_hits);
+        st.update("kept terms", m_stats.m_num_kept_terms);
         st.update("num checks", m_stats.m_num_checks);
         st.update("mk bool var", m_stats.m_num_mk_bool_var);
 
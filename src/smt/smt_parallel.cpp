@@ -17,13 +17,145 @@ Author:
 
 
 #include "util/scoped_ptr_vector.h"
+#include "util/uint_set.h"
 #include "ast/ast_util.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_ll_pp.h"
 #include "ast/ast_translation.h"
+#include "ast/for_each_expr.h"
 #include "smt/smt_parallel.h"
 #include "smt/smt_lookahead.h"
 
+namespace smt {
+
+    parallel::parallel(context& ctx):
+        ctx(ctx),
+        m_atoms(ctx.m),
+        m_num_exported(0),
+        m_num_dropped(0),
+        m_share_size(ctx.get_fparams().m_threads_share_size),
+        m_share_glue(ctx.get_fparams().m_threads_share_glue),
+        m_max_pool_size(1 << 22) {
+    }
+
+    void parallel::init_sharing(unsigned num_workers) {
+        m_pool.reset();
+        m_pool_head.reset();
+        m_pool_head.resize(num_workers, 0);
+        m_var2atom.reset();
+        m_var2atom.resize(num_workers);
+        m_atom2var.reset();
+        m_atom2var.resize(num_workers);
+        m_num_imported.reset();
+        m_num_imported.resize(num_workers, 0);
+    }
+
+    /**
+       \brief number the Boolean atoms that were created by pctx since the last call.
+       Atoms that contain skolem functions are not shared, since fresh symbols
+       created independently by different workers need not denote the same term.
+       The worker must be at base level and must not run concurrently.
+     */
+    void parallel::update_atoms(unsigned i, context& pctx) {
+        unsigned_vector& var2atom = m_var2atom[i];
+        svector<bool_var>& atom2var = m_atom2var[i];
+        unsigned num_vars = pctx.get_num_bool_vars();
+        ast_translation tr(pctx.m, ctx.m);
+        for (unsigned v = var2atom.size(); v < num_vars; ++v) {
+            expr* e = pctx.bool_var2expr(v);
+            unsigned atom = UINT_MAX;
+            if (e && !has_skolem_functions(e)) {
+                expr_ref ce(tr(e), ctx.m);
+                if (!m_expr2atom.find(ce, atom)) {
+                    atom = m_atoms.size();
+                    m_atoms.push_back(ce);
+                    m_expr2atom.insert(ce, atom);
+                }
+                atom2var.reserve(atom + 1, null_bool_var);
+                atom2var[atom] = v;
+            }
+            var2atom.push_back(atom);
+        }
+    }
+
+    void parallel::share_lemma(context& pctx, unsigned n, literal const* lits) {
+        if (n < 2 || n > m_share_size)
+            return;
+        unsigned i = pctx.m_par_index;
+        unsigned_vector const& var2atom = m_var2atom[i];
+        unsigned_vector clause;
+        clause.push_back(n);
+        clause.push_back(i);
+        uint_set levels;
+        for (unsigned j = 0; j < n; ++j) {
+            literal l = lits[j];
+            if (l.var() >= static_cast<bool_var>(var2atom.size()) || var2atom[l.var()] == UINT_MAX)
+                return;
+            levels.insert(pctx.get_assign_level(l));
+            clause.push_back(2 * var2atom[l.var()] + l.sign());
+        }
+        if (levels.num_elems() > m_share_glue)
+            return;
+        lock_guard lock(m_mux);
+        if (m_pool.size() + clause.size() > m_max_pool_size) {
+            unsigned head = m_pool.size();
+            for (unsigned h : m_pool_head)
+                head = std::min(head, h);
+            if (m_pool.size() - head + clause.size() > m_max_pool_size) {
+                ++m_num_dropped;
+                return;
+            }
+            for (unsigned j = head; j < m_pool.size(); ++j)
+                m_pool[j - head] = m_pool[j];
+            m_pool.shrink(m_pool.size() - head);
+            for (unsigned & h : m_pool_head)
+                h -= head;
+        }
+        m_pool.append(clause);
+        ++m_num_exported;
+    }
+
+    void parallel::import_lemmas(context& pctx) {
+        unsigned i = pctx.m_par_index;
+        unsigned_vector pool;
+        {
+            lock_guard lock(m_mux);
+            for (unsigned j = m_pool_head[i]; j < m_pool.size(); ++j)
+                pool.push_back(m_pool[j]);
+            m_pool_head[i] = m_pool.size();
+        }
+        svector<bool_var> const& atom2var = m_atom2var[i];
+        literal_vector lits;
+        for (unsigned j = 0; j < pool.size() && !pctx.inconsistent(); ) {
+            unsigned n = pool[j], owner = pool[j + 1];
+            unsigned const* atoms = pool.c_ptr() + j + 2;
+            j += n + 2;
+            if (owner == i)
+                continue;
+            lits.reset();
+            for (unsigned k = 0; k < n; ++k) {
+                unsigned atom = atoms[k] >> 1;
+                if (atom >= atom2var.size() || atom2var[atom] == null_bool_var)
+                    break;
+                lits.push_back(literal(atom2var[atom], (atoms[k] & 1) != 0));
+            }
+            if (lits.size() < n)
+                continue;
+            pctx.mk_clause(n, lits.c_ptr(), nullptr, CLS_TH_LEMMA);
+            ++m_num_imported[i];
+        }
+    }
+
+    void parallel::collect_statistics(::statistics& st) const {
+        unsigned num_imported = 0;
+        for (unsigned n : m_num_imported)
+            num_imported += n;
+        st.update("parallel lemmas exported", m_num_exported);
+        st.update("parallel lemmas dropped", m_num_dropped);
+        st.update("parallel lemmas imported", num_imported);
+    }
+}
+
 #ifdef SINGLE_THREAD
 
 namespace smt {
@@ -80,18 +212,71 @@ namespace smt {
         for (unsigned i = 0; i < num_threads; ++i) {
             smt_params.push_back(ctx.get_fparams());
         }
+        expr_ref_vector fmls(m), units(m);
+        proof_ref_vector prs(m);
+        ctx.collect_copy(true, fmls, prs, units);
         for (unsigned i = 0; i < num_threads; ++i) {
             ast_manager* new_m = alloc(ast_manager, m, true);
             pms.push_back(new_m);
             pctxs.push_back(alloc(context, *new_m, smt_params[i], ctx.get_params())); 
             context& new_ctx = *pctxs.back();
-            context::copy(ctx, new_ctx, true);
+            context::copy_setup(ctx, new_ctx);
             new_ctx.set_random_seed(i + ctx.get_fparams().m_random_seed);
-            ast_translation tr(m, *new_m);
-            pasms.push_back(tr(asms));
+            pasms.push_back(expr_ref_vector(*new_m));
             sl.push_child(&(new_m->limit()));
         }
 
+        std::mutex mux;
+
+        // translate and internalize the assertions of the workers concurrently.
+        // The manager of ctx is frozen meanwhile, such that it is only read.
+        auto copy_thread = [&](unsigned i) {
+            try {
+                context::copy_assertions(ctx, *pctxs[i], fmls, prs, units);
+                ast_translation tr(m, *pms[i], false);
+                pasms[i].append(tr(asms));
+            }
+            catch (z3_error & err) {
+                std::lock_guard<std::mutex> lock(mux);
+                error_code = err.error_code();
+                ex_kind = ERROR_EX;
+                done = true;
+            }
+            catch (z3_exception & ex) {
+                std::lock_guard<std::mutex> lock(mux);
+                ex_msg = ex.msg();
+                ex_kind = DEFAULT_EX;
+                done = true;
+            }
+        };
+        {
+            m.set_frozen(true);
+            vector<std::thread> threads(num_threads);
+            for (unsigned i = 0; i < num_threads; ++i) {
+                threads[i] = std::thread([&, i]() { copy_thread(i); });
+            }
+            for (auto & th : threads) {
+                th.join();
+            }
+            m.set_frozen(false);
+        }
+        if (done) {
+            switch (ex_kind) {
+            case ERROR_EX: throw z3_error(error_code);
+            default: throw default_exception(std::move(ex_msg));
+            }
+        }
+
+        bool share = m_share_size >= 2 && !m.proofs_enabled();
+        init_sharing(num_threads);
+        if (share) {
+            for (unsigned i = 0; i < num_threads; ++i) {
+                pctxs[i]->m_par = this;
+                pctxs[i]->m_par_index = i;
+                update_atoms(i, *pctxs[i]);
+            }
+        }
+
         auto cube = [](context& ctx, expr_ref_vector& lasms, expr_ref& c) {
             lookahead lh(ctx);
             c = lh.choose();
@@ -138,8 +323,6 @@ namespace smt {
             }
         };
 
-        std::mutex mux;
-
         auto worker_thread = [&](int i) {
             try {
                 context& pctx = *pctxs[i];
@@ -215,6 +398,15 @@ namespace smt {
             if (done) break;
 
             collect_units();
+            if (share) {
+                for (unsigned i = 0; i < num_threads; ++i) {
+                    context& pctx = *pctxs[i];
+                    pctx.pop_to_base_lvl();
+                    update_atoms(i, pctx);
+                    if (!pctx.inconsistent())
+                        import_lemmas(pctx);
+                }
+            }
             ++num_rounds;
             max_conflicts = (max_conflicts < thread_max_conflicts) ? 0 : (max_conflicts - thread_max_conflicts);
             thread_max_conflicts *= 2;            
@@ -223,6 +415,7 @@ namespace smt {
         for (context* c : pctxs) {
             c->collect_statistics(ctx.m_aux_stats);
         }
+        collect_statistics(ctx.m_aux_stats);
 
         if (finished_id == UINT_MAX) {
             switch (ex_kind) {
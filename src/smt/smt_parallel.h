@@ -18,17 +18,54 @@ Revision History:
 --*/
 #pragma once
 
+#include "util/mutex.h"
 #include "smt/smt_context.h"
 
 namespace smt {
 
     class parallel {
         context& ctx;
+
+        /**
+           Learned clauses are shared between workers over a common
+           numbering of Boolean atoms. Between rounds the atoms of each
+           worker are translated into the manager of ctx and numbered.
+           Clauses in m_pool are stored as the sequence
+           size, owner, 2*atom + sign, ..., 2*atom + sign.
+           The prefix that all workers imported is removed when the pool is full.
+         */
+        mutex                     m_mux;
+        unsigned_vector           m_pool;
+        unsigned_vector           m_pool_head;  // worker -> position of next clause to import
+        obj_map<expr, unsigned>   m_expr2atom;
+        expr_ref_vector           m_atoms;
+        vector<unsigned_vector>   m_var2atom;   // worker -> bool_var -> atom
+        vector<svector<bool_var>> m_atom2var;   // worker -> atom -> bool_var
+        unsigned_vector           m_num_imported;
+        unsigned                  m_num_exported;
+        unsigned                  m_num_dropped;
+        unsigned                  m_share_size;
+        unsigned                  m_share_glue;
+        unsigned                  m_max_pool_size;
+
+        void init_sharing(unsigned num_workers);
+        void update_atoms(unsigned i, context& pctx);
+        void collect_statistics(::statistics& st) const;
+
     public:
-        parallel(context& ctx): ctx(ctx) {}
+        parallel(context& ctx);
 
         lbool operator()(expr_ref_vector const& asms);
 
+        /**
+           \brief called by worker pctx when it learns a clause.
+         */
+        void share_lemma(context& pctx, unsigned n, literal const* lits);
+
+        /**
+           \brief add the clauses shared by other workers to pctx.
+         */
+        void import_lemmas(context& pctx);
     };
 
 }
@@ -0,0 +1,224 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    smt_qi_profile.cpp
+
+Abstract:
+
+    Profiling of quantifier instantiation.
+
+--*/
+#include <sstream>
+#include "ast/ast_pp.h"
+#include "smt/smt_qi_profile.h"
+
+namespace smt {
+
+    qi_profile::qi_profile(ast_manager & m):
+        m(m),
+        m_qs(m),
+        m_pats(m),
+        m_terms(m) {
+    }
+
+    unsigned qi_profile::get_idx(quantifier * q) {
+        unsigned idx;
+        if (m_q2idx.find(q, idx))
+            return idx;
+        idx = m_qs.size();
+        m_qs.push_back(q);
+        m_q2idx.insert(q, idx);
+        m_stats.push_back(qstat());
+        return idx;
+    }
+
+    void qi_profile::add_match(quantifier * q, app * pat) {
+        unsigned q_idx = get_idx(q);
+        m_stats[q_idx].m_matches++;
+        if (!pat)   // instances from model based quantifier instantiation have no pattern
+            return;
+        unsigned idx;
+        if (!m_pat2idx.find(q, pat, idx)) {
+            idx = m_pats.size();
+            m_pats.push_back(pat);
+            m_pat2idx.insert(q, pat, idx);
+            m_pat_matches.push_back(0);
+            m_pat2q.push_back(q_idx);
+        }
+        m_pat_matches[idx]++;
+    }
+
+    void qi_profile::add_instance(quantifier * q, unsigned num_bindings, enode * const * bindings, unsigned generation,
+                                  ptr_vector<enode> const & enodes, unsigned num_old_enodes) {
+        unsigned idx = get_idx(q);
+        qstat & s = m_stats[idx];
+        s.m_instances++;
+        s.m_generations[std::min(generation, max_generation_bucket)]++;
+        s.m_max_generation = std::max(s.m_max_generation, generation);
+        unsigned_vector srcs;
+        for (unsigned i = 0; i < num_bindings; ++i) {
+            unsigned src;
+            if (m_term2q.find(bindings[i]->get_owner(), src) && !srcs.contains(src))
+                srcs.push_back(src);
+        }
+        for (unsigned src : srcs) {
+            u_map<unsigned> & succs = m_stats[src].m_succs;
+            unsigned count = 0;
+            succs.find(idx, count);
+            succs.insert(idx, count + 1);
+        }
+        for (unsigned i = num_old_enodes; i < enodes.size(); ++i) {
+            app * t = enodes[i]->get_owner();
+            if (!m_term2q.contains(t))
+                m_terms.push_back(t);
+            m_term2q.insert(t, idx);
+        }
+    }
+
+    /**
+       \brief collect the strongly connected components of the dependency graph
+       that contain a cycle.
+     */
+    void qi_profile::find_loops(vector<unsigned_vector> & loops) const {
+        unsigned n = m_stats.size();
+        unsigned_vector index(n, UINT_MAX), low(n, 0u), stack;
+        bool_vector on_stack(n, false);
+        vector<std::pair<unsigned, unsigned_vector>> todo;
+        unsigned next_index = 0;
+        for (unsigned root = 0; root < n; ++root) {
+            if (index[root] != UINT_MAX)
+                continue;
+            todo.reset();
+            todo.push_back(std::make_pair(root, unsigned_vector()));
+            while (!todo.empty()) {
+                unsigned v = todo.back().first;
+                if (index[v] == UINT_MAX) {
+                    index[v] = low[v] = next_index++;
+                    stack.push_back(v);
+                    on_stack[v] = true;
+                    for (auto const & kv : m_stats[v].m_succs)
+                        todo.back().second.push_back(kv.m_key);
+                }
+                unsigned_vector & succs = todo.back().second;
+                if (!succs.empty()) {
+                    unsigned w = succs.back();
+                    succs.pop_back();
+                    if (index[w] == UINT_MAX)
+                        todo.push_back(std::make_pair(w, unsigned_vector()));
+                    else if (on_stack[w])
+                        low[v] = std::min(low[v], index[w]);
+                    continue;
+                }
+                todo.pop_back();
+                if (!todo.empty()) {
+                    unsigned u = todo.back().first;
+                    low[u] = std::min(low[u], low[v]);
+                }
+                if (low[v] != index[v])
+                    continue;
+                unsigned_vector scc;
+                unsigned w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    on_stack[w] = false;
+                    scc.push_back(w);
+                }
+                while (w != v);
+                if (scc.size() > 1 || m_stats[v].m_succs.contains(v))
+                    loops.push_back(scc);
+            }
+        }
+    }
+
+    void qi_profile::collect_statistics(::statistics & st) const {
+        vector<unsigned_vector> loops;
+        find_loops(loops);
+        unsigned num_loop_quantifiers = 0, max_generation = 0;
+        for (auto const & scc : loops)
+            num_loop_quantifiers += scc.size();
+        for (qstat const & s : m_stats)
+            max_generation = std::max(max_generation, s.m_max_generation);
+        st.update("qi profile quantifiers", m_stats.size());
+        st.update("qi profile loops", loops.size());
+        st.update("qi profile loop quantifiers", num_loop_quantifiers);
+        st.update("qi profile max generation", max_generation);
+    }
+
+    static std::ostream & display_json_string(std::ostream & out, std::string const & s) {
+        out << "\"";
+        for (char c : s) {
+            switch (c) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:   out << c; break;
+            }
+        }
+        return out << "\"";
+    }
+
+    static std::string qid2string(quantifier * q) {
+        std::ostringstream strm;
+        strm << q->get_qid();
+        return strm.str();
+    }
+
+    std::ostream & qi_profile::display_json(std::ostream & out) const {
+        vector<unsigned_vector> loops;
+        find_loops(loops);
+        bool_vector in_loop(m_stats.size(), false);
+        for (auto const & scc : loops)
+            for (unsigned i : scc)
+                in_loop[i] = true;
+
+        out << "{\n\"quantifiers\": [";
+        for (unsigned i = 0; i < m_stats.size(); ++i) {
+            qstat const & s = m_stats[i];
+            out << (i == 0 ? "\n" : ",\n") << "  {\"qid\": ";
+            display_json_string(out, qid2string(m_qs.get(i)));
+            out << ", \"matches\": " << s.m_matches
+                << ", \"instances\": " << s.m_instances
+                << ", \"time\": " << s.m_time
+                << ", \"max_generation\": " << s.m_max_generation
+                << ", \"loop\": " << (in_loop[i] ? "true" : "false")
+                << ", \"generations\": [";
+            for (unsigned g = 0; g < s.m_generations.size(); ++g)
+                out << (g == 0 ? "" : ", ") << s.m_generations[g];
+            out << "], \"triggers\": [";
+            bool first = true;
+            for (auto const & kv : s.m_succs) {
+                out << (first ? "" : ", ") << "{\"qid\": ";
+                display_json_string(out, qid2string(m_qs.get(kv.m_key)));
+                out << ", \"instances\": " << kv.m_value << "}";
+                first = false;
+            }
+            out << "]}";
+        }
+        out << "\n],\n\"patterns\": [";
+        for (unsigned i = 0; i < m_pats.size(); ++i) {
+            std::ostringstream strm;
+            strm << mk_pp(m_pats.get(i), m);
+            out << (i == 0 ? "\n" : ",\n") << "  {\"qid\": ";
+            display_json_string(out, qid2string(m_qs.get(m_pat2q[i])));
+            out << ", \"pattern\": ";
+            display_json_string(out, strm.str());
+            out << ", \"matches\": " << m_pat_matches[i] << "}";
+        }
+        out << "\n],\n\"loops\": [";
+        for (unsigned i = 0; i < loops.size(); ++i) {
+            out << (i == 0 ? "\n  [" : ",\n  [");
+            for (unsigned j = 0; j < loops[i].size(); ++j) {
+                out << (j == 0 ? "" : ", ");
+                display_json_string(out, qid2string(m_qs.get(loops[i][j])));
+            }
+            out << "]";
+        }
+        out << "\n]\n}\n";
+        return out;
+    }
+
+};
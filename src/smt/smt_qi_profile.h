@@ -0,0 +1,90 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    smt_qi_profile.h
+
+Abstract:
+
+    Profiling of quantifier instantiation.
+
+    The profile records per quantifier the number of matches and
+    instances, a histogram of instance generations and the time spent
+    instantiating. It also maintains an instantiation dependency graph:
+    there is an edge from q1 to q2 if an instance of q2 binds a term
+    that was created by an instance of q1. Quantifiers on cycles of this
+    graph are reported as potential matching loops.
+
+--*/
+#pragma once
+
+#include "ast/ast.h"
+#include "util/obj_hashtable.h"
+#include "util/obj_pair_hashtable.h"
+#include "util/statistics.h"
+#include "util/stopwatch.h"
+#include "smt/smt_enode.h"
+
+namespace smt {
+
+    class qi_profile {
+        static const unsigned max_generation_bucket = 16;
+
+        struct qstat {
+            unsigned        m_matches;
+            unsigned        m_instances;
+            unsigned        m_max_generation;
+            double          m_time;
+            unsigned_vector m_generations;  // histogram, the last bucket collects larger generations
+            u_map<unsigned> m_succs;        // quantifier index -> number of instances it triggered
+            qstat(): m_matches(0), m_instances(0), m_max_generation(0), m_time(0) {
+                m_generations.resize(max_generation_bucket + 1, 0);
+            }
+        };
+
+        ast_manager &           m;
+        quantifier_ref_vector   m_qs;
+        obj_map<quantifier, unsigned> m_q2idx;
+        vector<qstat>           m_stats;
+        app_ref_vector          m_pats;
+        obj_pair_map<quantifier, app, unsigned> m_pat2idx;
+        unsigned_vector         m_pat_matches;
+        unsigned_vector         m_pat2q;
+        obj_map<expr, unsigned> m_term2q;       // term -> quantifier that created it
+        expr_ref_vector         m_terms;        // keys of m_term2q are pinned, ids are not reused
+
+        unsigned get_idx(quantifier * q);
+        void find_loops(vector<unsigned_vector> & loops) const;
+
+    public:
+        qi_profile(ast_manager & m);
+
+        void add_match(quantifier * q, app * pat);
+
+        /**
+           \brief record an instance of q over the given bindings.
+           The enodes enodes[num_old_enodes:] were created when internalizing the instance.
+         */
+        void add_instance(quantifier * q, unsigned num_bindings, enode * const * bindings, unsigned generation,
+                          ptr_vector<enode> const & enodes, unsigned num_old_enodes);
+
+        void add_time(quantifier * q, double secs) { m_stats[get_idx(q)].m_time += secs; }
+
+        void collect_statistics(::statistics & st) const;
+
+        bool empty() const { return m_stats.empty(); }
+
+        std::ostream & display_json(std::ostream & out) const;
+
+        class scoped_time {
+            qi_profile * m_profile;
+            quantifier * m_q;
+            stopwatch    m_watch;
+        public:
+            scoped_time(qi_profile * p, quantifier * q): m_profile(p), m_q(q) { if (p) m_watch.start(); }
+            ~scoped_time() { if (m_profile) { m_watch.stop(); m_profile->add_time(m_q, m_watch.get_seconds()); } }
+        };
+    };
+
+};
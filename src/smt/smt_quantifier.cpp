@@ -551,6 +551,7 @@ namespace smt {
 
     void quantifier_manager::collect_statistics(::statistics & st) const {
         m_imp->m_qi_queue.collect_statistics(st);
+        m_imp->m_plugin->collect_statistics(st);
     }
 
     void quantifier_manager::reset_statistics() {
@@ -650,6 +651,11 @@ namespace smt {
             m_model_finder->pop_scope(num_scopes);            
         }
 
+        void collect_statistics(::statistics & st) const override {
+            m_mam->collect_statistics(st);
+            m_lazy_mam->collect_statistics(st);
+        }
+
         void init_search_eh() override {
             m_lazy_matching_idx = 0;
             m_model_finder->init_search_eh();
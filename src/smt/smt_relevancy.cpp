@@ -131,12 +131,14 @@ namespace smt {
         expr_ref_vector                m_relevant_exprs; 
         uint_set                       m_is_relevant;
         typedef list<relevancy_eh *>   relevancy_ehs;
-        obj_map<expr, relevancy_ehs *> m_relevant_ehs;
-        obj_map<expr, relevancy_ehs *> m_watches[2];
+        ptr_vector<relevancy_ehs>      m_relevant_ehs;  // indexed by expression id
+        ptr_vector<relevancy_ehs>      m_watches[2];    // indexed by expression id
+        uint_set                       m_justified;     // relevant gates that have a relevant justifying child
         struct eh_trail {
-            enum kind { POS_WATCH, NEG_WATCH, HANDLER };
+            enum kind { POS_WATCH, NEG_WATCH, HANDLER, JUSTIFIED };
             kind   m_kind;
             expr * m_node;
+            eh_trail(expr * n, kind k):m_kind(k), m_node(n) {}
             eh_trail(expr * n):m_kind(HANDLER), m_node(n) {}
             eh_trail(expr * n, bool val):m_kind(val ? POS_WATCH : NEG_WATCH), m_node(n) {}
             kind get_kind() const { return m_kind; }
@@ -158,32 +160,57 @@ namespace smt {
             undo_trail(0);
         }
 
+        static relevancy_ehs * get_ehs(ptr_vector<relevancy_ehs> const & ehs, expr * n) {
+            unsigned id = n->get_id();
+            return id < ehs.size() ? ehs[id] : nullptr;
+        }
+
+        static void set_ehs(ptr_vector<relevancy_ehs> & ehs, expr * n, relevancy_ehs * r) {
+            unsigned id = n->get_id();
+            if (id >= ehs.size()) {
+                if (r == nullptr)
+                    return;
+                ehs.resize(id + 1, nullptr);
+            }
+            ehs[id] = r;
+        }
+
         relevancy_ehs * get_handlers(expr * n) {
-            relevancy_ehs * r = nullptr;
-            m_relevant_ehs.find(n, r);
-            SASSERT(m_relevant_ehs.contains(n) || r == 0);
-            return r;
+            return get_ehs(m_relevant_ehs, n);
         }
 
         void set_handlers(expr * n, relevancy_ehs * ehs) {
-            if (ehs == nullptr)
-                m_relevant_ehs.erase(n);
-            else
-                m_relevant_ehs.insert(n, ehs);
+            set_ehs(m_relevant_ehs, n, ehs);
         }
 
         relevancy_ehs * get_watches(expr * n, bool val) {
-            relevancy_ehs * r = nullptr;
-            m_watches[val ? 1 : 0].find(n, r);
-            SASSERT(m_watches[val ? 1 : 0].contains(n) || r == 0);
-            return r;
+            return get_ehs(m_watches[val ? 1 : 0], n);
         }
 
         void set_watches(expr * n, bool val, relevancy_ehs * ehs) {
-            if (ehs == nullptr)
-                m_watches[val ? 1 : 0].erase(n);
-            else
-                m_watches[val ? 1 : 0].insert(n, ehs);
+            set_ehs(m_watches[val ? 1 : 0], n, ehs);
+        }
+
+        /**
+           \brief At relevancy level 3, a relevant or-gate (and-gate) that
+           has a relevant true (false) child is recorded as justified until
+           backtracking. Later assignments to its children are then handled
+           without rescanning the arguments of the gate.
+        */
+        bool justify_gates() const {
+            return m_context.relevancy_lvl() >= 3;
+        }
+
+        bool is_justified(app * n) const {
+            return m_justified.contains(n->get_id());
+        }
+
+        void set_justified(app * n) {
+            if (!justify_gates())
+                return;
+            SASSERT(!is_justified(n));
+            m_justified.insert(n->get_id());
+            push_trail(eh_trail(n, eh_trail::JUSTIFIED));
         }
 
         void push_trail(eh_trail const & t) {
@@ -295,6 +322,7 @@ namespace smt {
                 case eh_trail::POS_WATCH: ehs = get_watches(n, true); SASSERT(ehs); set_watches(n, true, ehs->tail()); break;
                 case eh_trail::NEG_WATCH: ehs = get_watches(n, false); SASSERT(ehs); set_watches(n, false, ehs->tail()); break;
                 case eh_trail::HANDLER:   ehs = get_handlers(n); SASSERT(ehs); set_handlers(n, ehs->tail()); break;
+                case eh_trail::JUSTIFIED: m_justified.remove(n->get_id()); break;
                 default: UNREACHABLE(); break;
                 }
                 m.dec_ref(n);
@@ -376,19 +404,25 @@ namespace smt {
             case l_undef:
                 break;
             case l_true: {
+                if (is_justified(n))
+                    return;
                 expr * true_arg = nullptr;
                 unsigned num_args = n->get_num_args();
                 for (unsigned i = 0; i < num_args; i++) {
                     expr * arg  = n->get_arg(i);
                     if (m_context.find_assignment(arg) == l_true) {
-                        if (is_relevant_core(arg))
+                        if (is_relevant_core(arg)) {
+                            set_justified(n);
                             return;
+                        }
                         else if (!true_arg)
                             true_arg = arg;
                     }
                 }
-                if (true_arg)
+                if (true_arg) {
                     mark_as_relevant(true_arg);
+                    set_justified(n);
+                }
                 break;
             } }
         }
@@ -400,19 +434,25 @@ namespace smt {
             lbool val    = m_context.find_assignment(n);
             switch (val) {
             case l_false: {
+                if (is_justified(n))
+                    return;
                 expr * false_arg = nullptr;
                 unsigned num_args = n->get_num_args();
                 for (unsigned i = 0; i < num_args; i++) {
                     expr * arg  = n->get_arg(i);
                     if (m_context.find_assignment(arg) == l_false) {
-                        if (is_relevant_core(arg))
+                        if (is_relevant_core(arg)) {
+                            set_justified(n);
                             return; 
+                        }
                         else if (!false_arg)
                             false_arg = arg;
                     }
                 }
-                if (false_arg)
+                if (false_arg) {
                     mark_as_relevant(false_arg);
+                    set_justified(n);
+                }
                 break;
             }
             case l_undef:
@@ -41,9 +41,13 @@ namespace smt {
         unsigned m_num_mk_lits;
         unsigned m_num_dyn_ack;
         unsigned m_num_del_dyn_ack;
+        unsigned m_num_dyn_ack_promotions;
+        unsigned m_num_dyn_ack_evictions;
         unsigned m_num_interface_eqs;
         unsigned m_max_generation;
         unsigned m_num_minimized_lits;
+        unsigned m_num_minimize_cache_hits;
+        unsigned m_num_kept_terms;
         unsigned m_num_checks;
         statistics() {
             reset();
@@ -25,10 +25,15 @@ Notes:
   3. Cube using the parameter settings prescribed in m_params.
   4. Optionally pass the cubes as assumptions and solve each sub-cube with a prescribed resource bound.
   5. Assemble cubes that could not be solved and create a cube state.
+
+ Cube states are kept on per-worker deques. Idle workers steal from the deques of other workers.
+ Open cubes are handed off when a batch is full or when conquering them takes longer than
+ conquer.split_time while other workers are idle.
  
 --*/
 
 #include "util/scoped_ptr_vector.h"
+#include "util/stopwatch.h"
 #include "ast/ast_pp.h"
 #include "ast/ast_util.h"
 #include "ast/ast_translation.h"
@@ -50,6 +55,7 @@ tactic * mk_parallel_tactic(solver* s, params_ref const& p) {
 #include <thread>
 #include <mutex>
 #include <cmath>
+#include <atomic>
 #include <condition_variable>
 
 class parallel_tactic : public tactic {
@@ -57,31 +63,62 @@ class parallel_tactic : public tactic {
 
     class solver_state; 
 
+    /**
+       Each worker owns a deque of tasks. The owner adds and takes tasks
+       at the back, such that it continues with the most recent split.
+       Workers without tasks steal the oldest task at the front of other
+       deques, which tends to be the task with the largest remaining width.
+       Workers only contend on the lock of a deque when stealing, and the
+       shared lock is only used to put idle workers to sleep.
+     */
     class task_queue {
+        struct worker_deque {
+            std::mutex               m_mutex;
+            ptr_vector<solver_state> m_tasks;
+            solver_state*            m_active;
+            worker_deque(): m_active(nullptr) {}
+        };
+        scoped_ptr_vector<worker_deque> m_deques;
         std::mutex                   m_mutex;
         std::condition_variable      m_cond;
-        ptr_vector<solver_state>     m_tasks;
-        ptr_vector<solver_state>     m_active;
-        unsigned                     m_num_waiters;
+        std::atomic<unsigned>        m_num_tasks;   // queued and active tasks
+        std::atomic<unsigned>        m_num_queued;
+        std::atomic<unsigned>        m_num_waiters;
+        std::atomic<unsigned>        m_num_steals;
         volatile bool                m_shutdown;
 
-        void inc_wait() {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            ++m_num_waiters;
-        }
-
-        void dec_wait() {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            --m_num_waiters;
-        }
-
-        solver_state* try_get_task() {
+        solver_state* try_get_task(unsigned id) {
             solver_state* st = nullptr;
-            std::lock_guard<std::mutex> lock(m_mutex);
-            if (!m_tasks.empty()) {
-                st = m_tasks.back();
-                m_tasks.pop_back();
-                m_active.push_back(st);
+            unsigned n = m_deques.size();
+            {
+                worker_deque& d = *m_deques[id];
+                std::lock_guard<std::mutex> lock(d.m_mutex);
+                if (!d.m_tasks.empty()) {
+                    st = d.m_tasks.back();
+                    d.m_tasks.pop_back();
+                    d.m_active = st;
+                    --m_num_queued;
+                    return st;
+                }
+            }
+            for (unsigned k = 1; !st && k < n; ++k) {
+                worker_deque& d = *m_deques[(id + k) % n];
+                std::lock_guard<std::mutex> lock(d.m_mutex);
+                if (!d.m_tasks.empty()) {
+                    st = d.m_tasks[0];
+                    d.m_tasks.erase(d.m_tasks.begin());
+                    ++m_num_steals;
+                }
+            }
+            if (st) {
+                --m_num_queued;
+                // a stolen task is published after the lock of the victim is
+                // released, so a shutdown in between did not cancel it.
+                worker_deque& d = *m_deques[id];
+                std::lock_guard<std::mutex> lock(d.m_mutex);
+                d.m_active = st;
+                if (m_shutdown)
+                    st->m().limit().cancel();
             }
             return st;
         }
@@ -89,78 +126,109 @@ class parallel_tactic : public tactic {
     public:
 
         task_queue(): 
+            m_num_tasks(0),
+            m_num_queued(0),
             m_num_waiters(0), 
+            m_num_steals(0),
             m_shutdown(false) {}             
 
         ~task_queue() { reset(); }
 
+        void init(unsigned num_workers) {
+            reset();
+            for (unsigned i = 0; i < num_workers; ++i) 
+                m_deques.push_back(alloc(worker_deque));
+        }
+
         void shutdown() {
             if (!m_shutdown) {
-                m_shutdown = true;
-                m_cond.notify_all();
-                std::lock_guard<std::mutex> lock(m_mutex);
-                for (solver_state* st : m_active) {
-                    st->m().limit().cancel();
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_shutdown = true;
+                    m_cond.notify_all();
+                }
+                for (worker_deque* d : m_deques) {
+                    std::lock_guard<std::mutex> lock(d->m_mutex);
+                    if (d->m_active) 
+                        d->m_active->m().limit().cancel();
                 }
             }
         }
 
         bool in_shutdown() const { return m_shutdown; }
 
-        void add_task(solver_state* task) {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_tasks.push_back(task);
+        void add_task(unsigned id, solver_state* task) {
+            ++m_num_tasks;
+            {
+                worker_deque& d = *m_deques[id];
+                std::lock_guard<std::mutex> lock(d.m_mutex);
+                d.m_tasks.push_back(task);
+            }
+            ++m_num_queued;
             if (m_num_waiters > 0) {
+                std::lock_guard<std::mutex> lock(m_mutex);
                 m_cond.notify_one();
             }            
         } 
 
-        bool is_idle() {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            return m_tasks.empty() && m_num_waiters > 0;
+        bool has_idle() const {
+            return m_num_waiters > 0 && m_num_queued == 0;
         }
 
-        solver_state* get_task() { 
+        unsigned num_steals() const { return m_num_steals; }
+
+        solver_state* get_task(unsigned id) { 
             while (!m_shutdown) {
-                inc_wait();
-                solver_state* st = try_get_task();
-                if (st) {
-                    dec_wait();
+                solver_state* st = try_get_task(id);
+                if (st) 
                     return st;
-                }
-                {
-                    std::unique_lock<std::mutex> lock(m_mutex);
+                std::unique_lock<std::mutex> lock(m_mutex);
+                ++m_num_waiters;
+                // add_task notifies under m_mutex after m_num_queued is incremented.
+                if (!m_shutdown && m_num_queued == 0)
                     m_cond.wait(lock);
-                }
-                dec_wait();
+                --m_num_waiters;
             }
             return nullptr;
         }
 
-        void task_done(solver_state* st) {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_active.erase(st);
-            if (m_tasks.empty() && m_active.empty()) {
+        void task_done(unsigned id, solver_state* st) {
+            {
+                worker_deque& d = *m_deques[id];
+                std::lock_guard<std::mutex> lock(d.m_mutex);
+                SASSERT(d.m_active == st);
+                d.m_active = nullptr;
+            }
+            if (--m_num_tasks == 0) {
+                std::lock_guard<std::mutex> lock(m_mutex);
                 m_shutdown = true;
                 m_cond.notify_all();
             }
         }
 
         void reset() {
-            for (auto* t : m_tasks) dealloc(t);
-            for (auto* t : m_active) dealloc(t);
-            m_tasks.reset();
-            m_active.reset();
+            for (worker_deque* d : m_deques) {
+                for (auto* t : d->m_tasks) dealloc(t);
+                if (d->m_active) dealloc(d->m_active);
+            }
+            m_deques.reset();
+            m_num_tasks = 0;
+            m_num_queued = 0;
             m_num_waiters = 0;
+            m_num_steals = 0;
             m_shutdown = false;
         }
 
         std::ostream& display(std::ostream& out) {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            out << "num_tasks " << m_tasks.size() << " active: " << m_active.size() << "\n";
-            for (solver_state* st : m_tasks) {
-                st->display(out);
+            for (unsigned i = 0; i < m_deques.size(); ++i) {
+                worker_deque& d = *m_deques[i];
+                std::lock_guard<std::mutex> lock(d.m_mutex);
+                out << "worker " << i << " num_tasks " << d.m_tasks.size() << " active: " << (d.m_active ? 1 : 0) << "\n";
+                for (solver_state* st : d.m_tasks) {
+                    st->display(out);
+                }
             }
+            out << "steals: " << m_num_steals << "\n";
             return out;
         }
 
@@ -352,6 +420,7 @@ private:
     unsigned      m_branches;
     unsigned      m_backtrack_frequency;
     unsigned      m_conquer_delay;
+    unsigned      m_conquer_split_time;
     volatile bool m_has_undef;
     bool          m_allsat;
     unsigned      m_num_unsat;
@@ -370,6 +439,7 @@ private:
         m_last_depth = 0;
         m_backtrack_frequency = pp.conquer_backtrack_frequency();
         m_conquer_delay = pp.conquer_delay();
+        m_conquer_split_time = pp.conquer_split_time();
         m_exn_code = 0;
         m_params.set_bool("override_incremental", true);
         m_core.reset();
@@ -462,7 +532,7 @@ private:
         close_branch(s, l_undef);
     }
 
-    void cube_and_conquer(solver_state& s) {
+    void cube_and_conquer(unsigned id, solver_state& s) {
         ast_manager& m = s.m();
         vector<cube_var> cube, hard_cubes, cubes;
         expr_ref_vector vars(m);
@@ -474,7 +544,7 @@ private:
         cube.append(s.split_cubes(1));
         SASSERT(cube.size() <= 1);
         IF_VERBOSE(2, verbose_stream() << "(tactic.parallel :split-cube " << cube.size() << ")\n";);
-        if (!s.cubes().empty()) m_queue.add_task(s.clone());
+        if (!s.cubes().empty()) m_queue.add_task(id, s.clone());
         if (!cube.empty()) {
             s.assert_cube(cube.get(0).cube());
             vars.reset();
@@ -506,6 +576,7 @@ private:
         unsigned cutoff = UINT_MAX;
         bool first = true;
         unsigned num_backtracks = 0, width = 0;
+        stopwatch conquer_watch;
         while (cutoff > 0 && !canceled(s)) {
             expr_ref_vector c = s.get_solver().cube(vars, cutoff);
             if (c.empty() || (cube.size() == 1 && m.is_true(c.back()))) {
@@ -524,7 +595,9 @@ private:
                 s.set_conquer_params(*conquer.get());
             }
             if (conquer) {
+                conquer_watch.start();
                 is_sat = conquer->check_sat(c);
+                conquer_watch.stop();
             }
             DEBUG_CODE(for (expr* e : c) SASSERT(e););
             switch (is_sat) {
@@ -554,10 +627,14 @@ private:
                 break;
 
             }
-            if (cubes.size() >= conquer_batch_size()) {
-                spawn_cubes(s, 10*width, cubes);
+            // hand off cubes when a batch is full, or earlier when the cubes
+            // turn out to be hard to conquer and other workers are idle.
+            if (cubes.size() >= conquer_batch_size() || 
+                (!cubes.empty() && m_queue.has_idle() && conquer_watch.get_seconds() * 1000 >= m_conquer_split_time)) {
+                spawn_cubes(id, s, 10*width, cubes);
                 first = false;
                 cubes.reset();
+                conquer_watch.reset();
             }
         }
 
@@ -579,13 +656,13 @@ private:
         }                
     }
 
-    void spawn_cubes(solver_state& s, unsigned width, vector<cube_var>& cubes) {
+    void spawn_cubes(unsigned id, solver_state& s, unsigned width, vector<cube_var>& cubes) {
         if (cubes.empty()) return;
         add_branches(cubes.size());
         s.set_cubes(cubes);
         solver_state* s1 = s.clone();
         s1->inc_width(width);
-        m_queue.add_task(s1);
+        m_queue.add_task(id, s1);
     }
 
     /*
@@ -637,12 +714,12 @@ private:
         return memory::above_high_watermark();
     }
 
-    void run_solver() {
+    void run_solver(unsigned id) {
         try {
-            while (solver_state* st = m_queue.get_task()) {
-                cube_and_conquer(*st);
+            while (solver_state* st = m_queue.get_task(id)) {
+                cube_and_conquer(id, *st);
                 collect_statistics(*st);
-                m_queue.task_done(st);
+                m_queue.task_done(id, st);
                 if (!st->m().inc()) m_queue.shutdown();
                 IF_VERBOSE(2, display(verbose_stream()););
                 dealloc(st);
@@ -676,7 +753,7 @@ private:
         add_branches(1);
         vector<std::thread> threads;
         for (unsigned i = 0; i < m_num_threads; ++i) 
-            threads.push_back(std::thread([this]() { run_solver(); }));
+            threads.push_back(std::thread([this, i]() { run_solver(i); }));
         for (std::thread& t : threads) 
             t.join();
         m_manager.limit().reset_cancel();
@@ -728,7 +805,8 @@ public:
             throw default_exception("parallel tactic does not work with trace");
         solver* s = m_solver->translate(m, m_params);
         solver_state* st = alloc(solver_state, nullptr, s, m_params);
-        m_queue.add_task(st);
+        m_queue.init(m_num_threads);
+        m_queue.add_task(0, st);
         expr_ref_vector clauses(m);
         ptr_vector<expr> assumptions;
         obj_map<expr, expr*> bool2dep;
@@ -785,6 +863,7 @@ public:
         m_params.copy(p);
         parallel_params pp(p);
         m_conquer_delay = pp.conquer_delay();
+        m_conquer_split_time = pp.conquer_split_time();
     }
 
     void collect_statistics(statistics & st) const override {
@@ -792,6 +871,7 @@ public:
         st.update("par unsat", m_num_unsat);
         st.update("par models", m_models.size());
         st.update("par progress", m_progress);
+        st.update("par steals", m_queue.num_steals());
     }
 
     void reset_statistics() override {
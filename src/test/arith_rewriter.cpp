@@ -8,6 +8,7 @@ Copyright (c) 2015 Microsoft Corporation
 #include "ast/ast_pp.h"
 #include "ast/reg_decl_plugins.h"
 #include "ast/rewriter/th_rewriter.h"
+#include "ast/rewriter/rewrite_memo.h"
 #include "model/model.h"
 #include "parsers/smt2/smt2parser.h"
 
@@ -34,7 +35,49 @@ static char const* example1 = "(<= (+ (* 1.3 x y) (* 2.3 y y) (* (- 1.1 x x))) 2
 static char const* example2 = "(= (+ 4 3 (- (* 3 x x) (* 5 y)) y) 0)";
 
 
+static unsigned get_stat(statistics const& st, char const* key) {
+    for (unsigned i = 0; i < st.size(); ++i)
+        if (st.is_uint(i) && strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    return 0;
+}
+
+static void tst_memo() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    expr_ref x(m.mk_const(symbol("x"), a.mk_real()), m);
+    expr_ref y(m.mk_const(symbol("y"), a.mk_real()), m);
+    expr_ref s(a.mk_add(a.mk_mul(a.mk_real(2), x), a.mk_mul(a.mk_real(3), x)), m);
+    expr_ref f1(a.mk_le(s, y), m), f2(a.mk_ge(s, y), m);
+    expr_ref r1(m), r2(m), r3(m);
+    params_ref p;
+    p.set_uint("memo_size", 10);
+    rewrite_memo memo(m, 0);
+    {
+        th_rewriter rw(m, p);
+        rw.set_memo(&memo);
+        rw(f1, r1);
+    }
+    // f1 and its shared subterm s are memoized
+    ENSURE(memo.size() == 2);
+    th_rewriter rw(m, p);
+    rw.set_memo(&memo);
+    rw(f2, r2);
+    rw.reset();
+    rw(f1, r3);
+    ENSURE(r1 == r3);
+    statistics st;
+    memo.collect_statistics(st);
+    ENSURE(get_stat(st, "rewrite memo hits") >= 2);
+    memo.set_max_size(1);
+    ENSURE(memo.size() == 1);
+    std::cout << mk_pp(r2, m) << "\n";
+}
+
 void tst_arith_rewriter() {
+    tst_memo();
+
     ast_manager m;
     reg_decl_plugins(m);
     arith_rewriter ar(m);
@@ -141,6 +141,25 @@ struct foo {
     bool           m_val2:1;
 };
 
+static void tst6() {
+    // deferred deletion of a chain of terms.
+    ast_manager m;
+    m.set_del_budget(10);
+    sort_ref b(m.mk_bool_sort(), m);
+    unsigned num_asts = m.get_num_asts();
+    {
+        expr_ref e(m.mk_const(symbol("p"), b.get()), m);
+        for (unsigned i = 0; i < 1000; ++i)
+            e = m.mk_not(e);
+    }
+    ENSURE(m.get_num_deferred() > 0);
+    ENSURE(m.get_num_asts() > num_asts);
+    ENSURE(!m.drain(100));
+    ENSURE(m.drain());
+    ENSURE(m.get_num_deferred() == 0);
+    ENSURE(m.get_num_asts() == num_asts);
+}
+
 void tst_ast() {
     TRACE("ast", 
           tout << "sizeof(ast):  " << sizeof(ast) << "\n";
@@ -153,5 +172,6 @@ void tst_ast() {
     tst3();
     tst4();
     tst5();
+    tst6();
 }
 
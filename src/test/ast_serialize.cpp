@@ -0,0 +1,132 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    ast_serialize.cpp
+
+Abstract:
+
+    Round trips of the binary AST format.
+
+--*/
+#include <fstream>
+#include <sstream>
+#include "ast/ast_serialize.h"
+#include "ast/ast_pp.h"
+#include "ast/reg_decl_plugins.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/bv_decl_plugin.h"
+#include "ast/array_decl_plugin.h"
+#include "ast/datatype_decl_plugin.h"
+
+static void mk_terms(ast_manager & m, ast_ref_vector & result) {
+    arith_util a(m);
+    bv_util bv(m);
+    array_util ar(m);
+    sort_ref int_s(a.mk_int(), m), bv_s(bv.mk_sort(8), m);
+    sort_ref arr_s(ar.mk_array_sort(int_s, bv_s), m);
+    sort_ref u(m.mk_uninterpreted_sort(symbol("U")), m);
+    expr_ref x(m.mk_const(symbol("x"), int_s), m), y(m.mk_const(symbol("y"), int_s), m);
+    expr_ref arr(m.mk_const(symbol("A"), arr_s), m);
+    func_decl_ref f(m.mk_func_decl(symbol("f"), int_s, u), m);
+    expr_ref shared(a.mk_add(x, a.mk_mul(a.mk_numeral(rational(-7, 3), false), y)), m);
+    result.push_back(a.mk_le(shared, a.mk_numeral(rational("123456789012345678901234567890"), true)));
+    expr * sel1[2] = { arr, shared };
+    expr * sel2[2] = { arr, x };
+    result.push_back(m.mk_eq(ar.mk_select(2, sel1), bv.mk_bv_add(bv.mk_numeral(rational(200), 8), ar.mk_select(2, sel2))));
+    expr * ds[3] = { m.mk_app(f, x.get()), m.mk_app(f, y.get()), m.mk_fresh_const("k", u) };
+    result.push_back(m.mk_distinct(3, ds));
+    sort * ss[1] = { int_s };
+    symbol ns[1] = { symbol("z") };
+    expr_ref body(a.mk_ge(m.mk_var(0, int_s), shared), m);
+    expr * pat_args[1] = { m.mk_app(f, m.mk_var(0, int_s)) };
+    expr_ref pat(m.mk_pattern(1, reinterpret_cast<app **>(pat_args)), m);
+    expr * pats[1] = { pat };
+    result.push_back(m.mk_forall(1, ss, ns, body, 3, symbol("q1"), symbol::null, 1, pats));
+    result.push_back(f);
+    result.push_back(u);
+    parameter p(int_s.get());
+    result.push_back(m.mk_uninterpreted_sort(symbol("P"), 1, &p));
+}
+
+static void tst_roundtrip(ast_manager & m1, ast_manager & m2) {
+    ast_ref_vector asts(m1), res(m2);
+    mk_terms(m1, asts);
+    std::stringstream strm;
+    serialize(m1, asts.size(), asts.c_ptr(), strm);
+    deserialize(m2, strm, res);
+    VERIFY(asts.size() == res.size());
+    for (unsigned i = 0; i < asts.size(); ++i) {
+        if (&m1 == &m2) {
+            VERIFY(asts.get(i) == res.get(i));
+        }
+        else {
+            std::ostringstream s1, s2;
+            s1 << mk_pp(asts.get(i), m1);
+            s2 << mk_pp(res.get(i), m2);
+            VERIFY(s1.str() == s2.str());
+        }
+    }
+}
+
+void tst_ast_serialize() {
+    ast_manager m1, m2;
+    reg_decl_plugins(m1);
+    reg_decl_plugins(m2);
+    tst_roundtrip(m1, m1);
+    tst_roundtrip(m1, m2);
+
+    // truncated streams are rejected.
+    ast_ref_vector asts(m1), res(m1);
+    mk_terms(m1, asts);
+    std::stringstream strm;
+    serialize(m1, asts.size(), asts.c_ptr(), strm);
+    std::string s = strm.str();
+    std::istringstream in(s.substr(0, s.size() / 2));
+    bool failed = false;
+    try {
+        deserialize(m1, in, res);
+    }
+    catch (default_exception &) {
+        failed = true;
+    }
+    VERIFY(failed);
+
+    // a corrupt symbol length is rejected without allocating it.
+    char const corrupt[] = { 'Z', '3', 'A', 'B', 1, 2, 2, '\xff', '\xff', '\xff', '\xff', '\x0f', 'a', 'b' };
+    std::istringstream in2(std::string(corrupt, sizeof(corrupt)));
+    failed = false;
+    try {
+        deserialize(m1, in2, res);
+    }
+    catch (default_exception &) {
+        failed = true;
+    }
+    VERIFY(failed);
+
+    // datatypes depend on definitions that are not part of the stream.
+    datatype_util dtu(m1);
+    datatype_decl_plugin * dt = static_cast<datatype_decl_plugin*>(m1.get_plugin(m1.get_family_id("datatype")));
+    constructor_decl * cs[1] = { mk_constructor_decl(symbol("C"), symbol("is-C"), 0, nullptr) };
+    datatype_decl * d = mk_datatype_decl(dtu, symbol("D"), 0, nullptr, 1, cs);
+    sort_ref_vector dts(m1);
+    VERIFY(dt->mk_datatypes(1, &d, 0, nullptr, dts));
+    del_datatype_decl(d);
+    ast_ref c(m1.mk_const(dtu.get_datatype_constructors(dts.get(0))->get(0)), m1);
+    ast * roots[1] = { c };
+    std::stringstream strm2;
+    failed = false;
+    try {
+        serialize(m1, 1, roots, strm2);
+    }
+    catch (default_exception &) {
+        failed = true;
+    }
+    VERIFY(failed);
+
+    // failed writes are reported on the stream.
+    std::ofstream out;
+    serialize(m1, asts.size(), asts.c_ptr(), out);
+    VERIFY(!out);
+}
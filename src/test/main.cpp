@@ -156,6 +156,7 @@ int main(int argc, char ** argv) {
     TST(rational);
     TST(inf_rational);
     TST(ast);
+    TST(ast_serialize);
     TST(optional);
     TST(bit_vector);
     TST(fixed_bit_vector);
@@ -246,6 +247,9 @@ int main(int argc, char ** argv) {
     TST(theory_pb);
     TST(simplex);
     TST(sat_user_scope);
+    TST(sat_vivify);
+    TST(sat_bva);
+    TST(sat_xor_gauss);
     TST_ARGV(ddnf);
     TST(ddnf1);
     TST(model_evaluator);
@@ -253,6 +257,9 @@ int main(int argc, char ** argv) {
     TST(pb2bv);
     TST_ARGV(sat_lookahead);
     TST_ARGV(sat_local_search);
+    TST_ARGV(sat_propagate);
+    TST_ARGV(sat_parallel);
+    TST_ARGV(smt2_throughput);
     TST_ARGV(cnf_backbones);
     TST(bdd);
     TST(pdd);
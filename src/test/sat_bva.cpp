@@ -0,0 +1,137 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    sat_bva.cpp
+
+Abstract:
+
+    Bounded variable addition on CNFs that contain the pattern
+    l_i \/ C_j for all i, j. Results are compared with a solver without
+    bounded variable addition, and models, which are reconstructed
+    over the fresh variables, are checked against the input clauses.
+
+--*/
+
+#include <cstring>
+#include "sat/sat_solver.h"
+#include "util/util.h"
+
+typedef sat::literal_vector clause_t;
+typedef vector<clause_t> clauses_t;
+
+static void add_random_clauses(random_gen& r, unsigned num_vars, unsigned num_clauses, clauses_t& cls) {
+    for (unsigned i = 0; i < num_clauses; ++i) {
+        clause_t c;
+        while (c.size() < 3) {
+            sat::literal l(r(num_vars) + 1, r(2) == 0);
+            if (!c.contains(l) && !c.contains(~l))
+                c.push_back(l);
+        }
+        cls.push_back(c);
+    }
+}
+
+// the clauses l_i \/ C_j for num_lits literals l_i and num_cls clauses C_j
+// of two literals over fresh variables starting at first_var.
+static unsigned add_pattern(random_gen& r, unsigned first_var, unsigned num_lits, unsigned num_cls, clauses_t& cls) {
+    unsigned v = first_var;
+    clause_t lits;
+    for (unsigned i = 0; i < num_lits; ++i)
+        lits.push_back(sat::literal(v++, r(2) == 0));
+    clauses_t cs;
+    for (unsigned j = 0; j < num_cls; ++j) {
+        clause_t c;
+        c.push_back(sat::literal(v++, r(2) == 0));
+        c.push_back(sat::literal(v++, r(2) == 0));
+        cs.push_back(c);
+    }
+    for (sat::literal l : lits) {
+        for (clause_t const& c : cs) {
+            clause_t d(c);
+            d.push_back(l);
+            cls.push_back(d);
+        }
+    }
+    return v;
+}
+
+static bool is_model(sat::model const& mdl, clauses_t const& cls) {
+    for (clause_t const& c : cls) {
+        bool sat = false;
+        for (sat::literal l : c)
+            sat |= mdl[l.var()] == (l.sign() ? l_false : l_true);
+        if (!sat)
+            return false;
+    }
+    return true;
+}
+
+static unsigned get_stat(sat::solver& s, char const* key) {
+    statistics st;
+    s.collect_statistics(st);
+    for (unsigned i = 0; i < st.size(); ++i)
+        if (strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    return 0;
+}
+
+static lbool check(params_ref const& p, unsigned num_vars, clauses_t const& cls, unsigned& num_added, unsigned& num_removed) {
+    reslimit rlim;
+    sat::solver s(p, rlim);
+    for (unsigned i = 0; i < num_vars; ++i)
+        s.mk_var();
+    for (clause_t const& c : cls)
+        s.mk_clause(c.size(), c.c_ptr());
+    lbool r = s.check();
+    if (r == l_true)
+        VERIFY(is_model(s.get_model(), cls));
+    num_added += get_stat(s, "sat bva vars");
+    num_removed += get_stat(s, "sat bva removed");
+    return r;
+}
+
+void tst_sat_bva() {
+    random_gen r(0);
+    params_ref p, q;
+    p.set_bool("bva", true);
+    // simplify before the first bounded search, which solves these instances.
+    p.set_bool("enable_pre_simplify", true);
+    unsigned num_reconstructed = 0, num_unsat = 0;
+    for (unsigned i = 0; i < 20; ++i) {
+        clauses_t cls;
+        unsigned num_vars = add_pattern(r, 1, 4 + i % 3, 5, cls);
+        num_vars = add_pattern(r, num_vars, 3, 6, cls);
+        // the random clauses also constrain the variables of the patterns.
+        add_random_clauses(r, num_vars - 1, 3 * num_vars + 4 * i, cls);
+        unsigned num_added = 0, num_removed = 0, dummy = 0;
+        lbool r1 = check(p, num_vars, cls, num_added, num_removed);
+        lbool r2 = check(q, num_vars, cls, dummy, dummy);
+        std::cout << r1 << " " << num_added << "\n";
+        VERIFY(r1 == r2);
+        // models were reconstructed over the variables added by bva.
+        num_reconstructed += r1 == l_true && num_added > 0;
+        num_unsat += r1 == l_false && num_added > 0;
+    }
+    VERIFY(num_reconstructed > 0 && num_unsat > 0);
+
+    // a duplicated clause l_i \/ C_j matches the partners of both copies,
+    // each partner is removed only once.
+    for (unsigned i = 0; i < 10; ++i) {
+        clauses_t cls;
+        unsigned num_vars = add_pattern(r, 1, 4, 5, cls);
+        unsigned sz = cls.size();
+        for (unsigned j = 0; j < sz; ++j) {
+            clause_t c(cls[j]);
+            cls.push_back(c);
+        }
+        add_random_clauses(r, num_vars - 1, 2 * num_vars + 4 * i, cls);
+        unsigned num_added = 0, num_removed = 0, dummy = 0;
+        lbool r1 = check(p, num_vars, cls, num_added, num_removed);
+        lbool r2 = check(q, num_vars, cls, dummy, dummy);
+        std::cout << r1 << " " << num_removed << "\n";
+        VERIFY(r1 == r2);
+        VERIFY(num_removed <= 2 * sz);
+    }
+}
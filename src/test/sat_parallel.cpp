@@ -0,0 +1,66 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    sat_parallel.cpp
+
+Abstract:
+
+    Scaling benchmark for parallel SAT solving with clause sharing.
+    Usage: test-z3 sat_parallel file.cnf [sat.max_conflicts=N]
+
+    The DIMACS file is solved with 1, 2, 4, 8, 16 and 32 threads and the
+    time together with the number of exported, imported and dropped
+    clauses is reported for each run.
+
+--*/
+#include <fstream>
+#include <cstring>
+#include "util/rlimit.h"
+#include "util/stopwatch.h"
+#include "util/statistics.h"
+#include "util/gparams.h"
+#include "sat/dimacs.h"
+#include "sat/sat_solver.h"
+
+static void display_stat(statistics const& st, char const* key) {
+    for (unsigned i = 0; i < st.size(); ++i)
+        if (st.is_uint(i) && strcmp(st.get_key(i), key) == 0)
+            std::cout << " " << key + 8 << ": " << st.get_uint_value(i);
+}
+
+static void solve_parallel(char const* file_name, unsigned num_threads) {
+    std::ifstream in(file_name);
+    if (in.bad() || in.fail()) {
+        std::cout << "File not found " << file_name << "\n";
+        return;
+    }
+    reslimit limit;
+    params_ref p = gparams::get_module("sat");
+    p.set_uint("threads", num_threads);
+    sat::solver solver(p, limit);
+    if (!parse_dimacs(in, std::cerr, solver))
+        return;
+    stopwatch sw;
+    sw.start();
+    lbool r = solver.check();
+    sw.stop();
+    statistics st;
+    solver.collect_statistics(st);
+    std::cout << "threads: " << num_threads << " " << r << " time: " << sw.get_seconds();
+    display_stat(st, "sat par exported");
+    display_stat(st, "sat par imported");
+    display_stat(st, "sat par dropped");
+    std::cout << "\n";
+}
+
+void tst_sat_parallel(char ** argv, int argc, int& i) {
+    if (i + 1 >= argc) {
+        std::cout << "require dimacs file name\n";
+        return;
+    }
+    char const* file_name = argv[++i];
+    for (unsigned num_threads = 1; num_threads <= 32; num_threads *= 2)
+        solve_parallel(file_name, num_threads);
+}
@@ -0,0 +1,71 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    sat_propagate.cpp
+
+Abstract:
+
+    Propagation throughput benchmark for the SAT core.
+    Usage: test-z3 sat_propagate file1.cnf file2.cnf ... [sat.max_conflicts=N]
+
+    Each DIMACS file is solved up to the conflict budget and the number of
+    propagations per second is reported, such that changes to the watch list
+    and clause layout can be compared across builds and configurations,
+    e.g., sat.gc.small_arena=true versus sat.gc.small_arena=false.
+
+--*/
+#include <fstream>
+#include <cstring>
+#include "util/rlimit.h"
+#include "util/stopwatch.h"
+#include "util/statistics.h"
+#include "util/gparams.h"
+#include "sat/dimacs.h"
+#include "sat/sat_solver.h"
+
+static unsigned count_propagations(statistics const& st) {
+    unsigned r = 0;
+    for (unsigned i = 0; i < st.size(); ++i)
+        if (st.is_uint(i) && strncmp(st.get_key(i), "sat propagations", 16) == 0)
+            r += st.get_uint_value(i);
+    return r;
+}
+
+static void propagate_file(char const* file_name, double& total_time, double& total_props) {
+    std::ifstream in(file_name);
+    if (in.bad() || in.fail()) {
+        std::cout << "File not found " << file_name << "\n";
+        return;
+    }
+    reslimit limit;
+    params_ref p = gparams::get_module("sat");
+    if (!p.contains("max_conflicts"))
+        p.set_uint("max_conflicts", 100000);
+    sat::solver solver(p, limit);
+    if (!parse_dimacs(in, std::cerr, solver))
+        return;
+    stopwatch sw;
+    sw.start();
+    lbool r = solver.check();
+    sw.stop();
+    statistics st;
+    solver.collect_statistics(st);
+    double props = count_propagations(st);
+    double secs  = sw.get_seconds();
+    total_time  += secs;
+    total_props += props;
+    std::cout << file_name << " " << r << " propagations: " << props
+              << " time: " << secs
+              << " props/sec: " << (secs > 0 ? props / secs : 0) << "\n";
+}
+
+void tst_sat_propagate(char ** argv, int argc, int& i) {
+    std::cout << "watched size: " << sizeof(sat::watched) << " bytes\n";
+    double total_time = 0, total_props = 0;
+    for (; i + 1 < argc && !strchr(argv[i + 1], '='); ++i)
+        propagate_file(argv[i + 1], total_time, total_props);
+    if (total_time > 0)
+        std::cout << "total props/sec: " << total_props / total_time << "\n";
+}
@@ -0,0 +1,115 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    sat_vivify.cpp
+
+Abstract:
+
+    Vivification of learned clauses on random and crafted CNFs.
+    Results are compared with a solver without vivification
+    and models are checked against the input clauses.
+
+--*/
+
+#include <cstring>
+#include "sat/sat_solver.h"
+#include "util/util.h"
+
+typedef sat::literal_vector clause_t;
+typedef vector<clause_t> clauses_t;
+
+static void add_random_clauses(random_gen& r, unsigned num_vars, unsigned num_clauses, clauses_t& cls) {
+    for (unsigned i = 0; i < num_clauses; ++i) {
+        clause_t c;
+        while (c.size() < 3) {
+            sat::literal l(r(num_vars) + 1, r(2) == 0);
+            if (!c.contains(l) && !c.contains(~l))
+                c.push_back(l);
+        }
+        cls.push_back(c);
+    }
+}
+
+// n+1 pigeons in n holes, the variable of pigeon i in hole j is 1 + i*n + j.
+static unsigned add_pigeon_hole(unsigned n, clauses_t& cls) {
+    auto var = [&](unsigned i, unsigned j) { return 1 + i * n + j; };
+    for (unsigned i = 0; i <= n; ++i) {
+        clause_t c;
+        for (unsigned j = 0; j < n; ++j)
+            c.push_back(sat::literal(var(i, j), false));
+        cls.push_back(c);
+    }
+    for (unsigned j = 0; j < n; ++j)
+        for (unsigned i = 0; i <= n; ++i)
+            for (unsigned k = i + 1; k <= n; ++k) {
+                clause_t c;
+                c.push_back(sat::literal(var(i, j), true));
+                c.push_back(sat::literal(var(k, j), true));
+                cls.push_back(c);
+            }
+    return (n + 1) * n;
+}
+
+static bool is_model(sat::model const& mdl, clauses_t const& cls) {
+    for (clause_t const& c : cls) {
+        bool sat = false;
+        for (sat::literal l : c)
+            sat |= mdl[l.var()] == (l.sign() ? l_false : l_true);
+        if (!sat)
+            return false;
+    }
+    return true;
+}
+
+static unsigned get_stat(sat::solver& s, char const* key) {
+    statistics st;
+    s.collect_statistics(st);
+    for (unsigned i = 0; i < st.size(); ++i)
+        if (strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    return 0;
+}
+
+static lbool check(params_ref const& p, unsigned num_vars, clauses_t const& cls, unsigned& num_checked) {
+    reslimit rlim;
+    sat::solver s(p, rlim);
+    for (unsigned i = 0; i <= num_vars; ++i)
+        s.mk_var();
+    for (clause_t const& c : cls)
+        s.mk_clause(c.size(), c.c_ptr());
+    lbool r = s.check();
+    if (r == l_true)
+        VERIFY(is_model(s.get_model(), cls));
+    num_checked += get_stat(s, "sat vivify tier1 checked");
+    num_checked += get_stat(s, "sat vivify tier2 checked");
+    num_checked += get_stat(s, "sat vivify local checked");
+    return r;
+}
+
+static void check_vivify(unsigned num_vars, clauses_t const& cls, unsigned& num_checked) {
+    params_ref p, q;
+    p.set_bool("vivify", true);
+    p.set_uint("vivify.delay", 0);
+    unsigned dummy = 0;
+    lbool r1 = check(p, num_vars, cls, num_checked);
+    lbool r2 = check(q, num_vars, cls, dummy);
+    std::cout << r1 << "\n";
+    VERIFY(r1 == r2);
+}
+
+void tst_sat_vivify() {
+    random_gen r(0);
+    unsigned num_checked = 0;
+    for (unsigned i = 0; i < 20; ++i) {
+        clauses_t cls;
+        unsigned num_vars = 100;
+        add_random_clauses(r, num_vars, 380 + 5 * i, cls);
+        check_vivify(num_vars, cls, num_checked);
+    }
+    clauses_t cls;
+    unsigned num_vars = add_pigeon_hole(7, cls);
+    check_vivify(num_vars, cls, num_checked);
+    VERIFY(num_checked > 0);
+}
@@ -0,0 +1,154 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    sat_xor_gauss.cpp
+
+Abstract:
+
+    Gauss-Jordan elimination over random XOR systems, mixed with clauses.
+    Results are compared with a solver over the CNF encoding of the XORs,
+    and models are checked against the XORs and clauses.
+
+--*/
+
+#include <cstring>
+#include "sat/sat_solver.h"
+#include "sat/ba_solver.h"
+#include "util/util.h"
+
+typedef sat::literal_vector clause_t;
+typedef vector<clause_t> clauses_t;
+
+// an XOR is satisfied if an odd number of its literals is true.
+static void add_random_xors(random_gen& r, unsigned num_vars, unsigned num_xors, clauses_t& xors) {
+    for (unsigned i = 0; i < num_xors; ++i) {
+        clause_t x;
+        unsigned sz = 3 + r(2);
+        while (x.size() < sz) {
+            sat::literal l(r(num_vars) + 1, false);
+            if (!x.contains(l))
+                x.push_back(l);
+        }
+        if (r(2) == 0)
+            x[0].neg();
+        xors.push_back(x);
+    }
+}
+
+static void add_random_clauses(random_gen& r, unsigned num_vars, unsigned num_clauses, clauses_t& cls) {
+    for (unsigned i = 0; i < num_clauses; ++i) {
+        clause_t c;
+        while (c.size() < 3) {
+            sat::literal l(r(num_vars) + 1, r(2) == 0);
+            if (!c.contains(l) && !c.contains(~l))
+                c.push_back(l);
+        }
+        cls.push_back(c);
+    }
+}
+
+// one clause for each assignment with an even number of true literals.
+static void xor2cnf(clause_t const& x, clauses_t& cls) {
+    for (unsigned mask = 0; mask < (1u << x.size()); ++mask) {
+        bool odd = false;
+        clause_t c;
+        for (unsigned i = 0; i < x.size(); ++i) {
+            bool is_true = (mask & (1u << i)) != 0;
+            odd ^= is_true;
+            c.push_back(is_true ? ~x[i] : x[i]);
+        }
+        if (!odd)
+            cls.push_back(c);
+    }
+}
+
+static bool is_true(sat::model const& mdl, sat::literal l) {
+    return mdl[l.var()] == (l.sign() ? l_false : l_true);
+}
+
+static bool is_model(sat::model const& mdl, clauses_t const& xors, clauses_t const& cls) {
+    for (clause_t const& x : xors) {
+        bool odd = false;
+        for (sat::literal l : x)
+            odd ^= is_true(mdl, l);
+        if (!odd)
+            return false;
+    }
+    for (clause_t const& c : cls) {
+        bool sat = false;
+        for (sat::literal l : c)
+            sat |= is_true(mdl, l);
+        if (!sat)
+            return false;
+    }
+    return true;
+}
+
+static unsigned get_stat(sat::solver& s, char const* key) {
+    statistics st;
+    s.collect_statistics(st);
+    for (unsigned i = 0; i < st.size(); ++i)
+        if (strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    return 0;
+}
+
+static lbool check_gauss(unsigned num_vars, clauses_t const& xors, clauses_t const& cls, unsigned& num_inits) {
+    params_ref p;
+    p.set_bool("xor.gauss", true);
+    // the XORs are simplified and the matrix is built before the first bounded search.
+    p.set_bool("enable_pre_simplify", true);
+    reslimit rlim;
+    sat::solver s(p, rlim);
+    sat::ba_solver* ba = alloc(sat::ba_solver);
+    s.set_extension(ba);
+    for (unsigned i = 0; i <= num_vars; ++i)
+        s.mk_var(true);
+    for (clause_t const& x : xors)
+        ba->add_xr(x);
+    for (clause_t const& c : cls)
+        s.mk_clause(c.size(), c.c_ptr());
+    lbool r = s.check();
+    if (r == l_true)
+        VERIFY(is_model(s.get_model(), xors, cls));
+    num_inits += get_stat(s, "ba gauss inits");
+    return r;
+}
+
+static lbool check_cnf(unsigned num_vars, clauses_t const& xors, clauses_t const& cls) {
+    params_ref p;
+    reslimit rlim;
+    sat::solver s(p, rlim);
+    for (unsigned i = 0; i <= num_vars; ++i)
+        s.mk_var();
+    clauses_t all(cls);
+    for (clause_t const& x : xors)
+        xor2cnf(x, all);
+    for (clause_t const& c : all)
+        s.mk_clause(c.size(), c.c_ptr());
+    lbool r = s.check();
+    if (r == l_true)
+        VERIFY(is_model(s.get_model(), xors, cls));
+    return r;
+}
+
+void tst_sat_xor_gauss() {
+    random_gen r(0);
+    unsigned num_inits = 0, num_sat = 0, num_unsat = 0;
+    for (unsigned i = 0; i < 30; ++i) {
+        unsigned num_vars = 40;
+        clauses_t xors, cls;
+        add_random_xors(r, num_vars, 30 + i % 15, xors);
+        add_random_clauses(r, num_vars, 20, cls);
+        lbool r1 = check_gauss(num_vars, xors, cls, num_inits);
+        lbool r2 = check_cnf(num_vars, xors, cls);
+        std::cout << r1 << "\n";
+        VERIFY(r1 == r2);
+        num_sat += r1 == l_true;
+        num_unsat += r1 == l_false;
+    }
+    VERIFY(num_inits > 0);
+    VERIFY(num_sat > 0 && num_unsat > 0);
+}
@@ -8,8 +8,39 @@ Copyright (c) 2015 Microsoft Corporation
 #include "util/util.h"
 #include "util/trace.h"
 #include "util/small_object_allocator.h"
+#include "util/vector.h"
+
+static void tst_release(bool huge_pages) {
+    small_object_allocator soa;
+    soa.set_huge_pages(huge_pages);
+    ptr_vector<char> objs;
+    for (unsigned i = 0; i < 100000; ++i)
+        objs.push_back(new (soa) char[24]);
+    unsigned num_chunks = soa.get_num_chunks();
+    // keep every 1000th object, such that most chunks become free.
+    for (unsigned i = 0; i < objs.size(); ++i)
+        if (i % 1000 != 0)
+            soa.deallocate(24, objs[i]);
+    unsigned num_released = soa.release_free_chunks();
+    ENSURE(soa.get_num_chunks() + num_released == num_chunks);
+    ENSURE(soa.get_num_objs() == (num_chunks == 0 ? 0u : 100u));
+    for (unsigned i = 0; i < objs.size(); i += 1000)
+        soa.deallocate(24, objs[i]);
+    for (unsigned i = 0; i < objs.size(); ++i)
+        objs[i] = new (soa) char[24];
+    for (char * p : objs)
+        soa.deallocate(24, p);
+    soa.consolidate();
+    ENSURE(soa.get_num_chunks() == 0 && soa.get_num_free_objs() == 0);
+#if !defined(Z3DEBUG) || defined(_WINDOWS)
+    ENSURE(num_released > 0);
+#endif
+}
 
 void tst_small_object_allocator() {
+    tst_release(false);
+    tst_release(true);
+
     small_object_allocator soa;
 
     char * p1 = new (soa) char[13];
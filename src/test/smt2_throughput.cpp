@@ -0,0 +1,82 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    smt2_throughput.cpp
+
+Abstract:
+
+    Parse throughput benchmark for the SMT-LIB2 front end.
+    Usage: test-z3 smt2_throughput [file1.smt2 file2.smt2 ...]
+
+    Each input is parsed from an input stream and in place from memory,
+    and the throughput of both is reported in MB/s. Without files,
+    a generated benchmark is used. check-sat commands are ignored.
+
+--*/
+#include <sstream>
+#include <cstring>
+#include "util/stopwatch.h"
+#include "util/mapped_file.h"
+#include "ast/reg_decl_plugins.h"
+#include "parsers/smt2/smt2parser.h"
+
+static std::string mk_benchmark(unsigned num_vars, unsigned num_asserts) {
+    std::ostringstream strm;
+    strm << "; generated benchmark\n(set-logic QF_LIA)\n";
+    for (unsigned i = 0; i < num_vars; ++i)
+        strm << "(declare-fun x" << i << " () Int)\n";
+    for (unsigned i = 0; i < num_asserts; ++i) {
+        unsigned a = i % num_vars, b = (7 * i + 3) % num_vars, c = (13 * i + 5) % num_vars;
+        strm << "(assert (! (<= (+ x" << a << " (* " << (i % 97) << " x" << b << ") 123456789012345678901234)"
+             << " (- x" << c << " " << i << ".5)) :named |a " << i << "|)) ; constraint " << i << "\n";
+    }
+    strm << "(check-sat)\n";
+    return strm.str();
+}
+
+static double parse(ast_manager & m, expr_ref_vector & fmls, char const * begin, char const * end, bool use_stream) {
+    cmd_context ctx(false, &m);
+    ctx.set_ignore_check(true);
+    std::istringstream is(use_stream ? std::string(begin, end) : std::string());
+    stopwatch sw;
+    sw.start();
+    bool ok = use_stream ? parse_smt2_commands(ctx, is) : parse_smt2_commands(ctx, begin, end);
+    VERIFY(ok);
+    sw.stop();
+    fmls.append(ctx.assertions().size(), ctx.assertions().c_ptr());
+    return sw.get_seconds();
+}
+
+static void throughput(char const * name, char const * begin, char const * end) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    expr_ref_vector fmls1(m), fmls2(m);
+    double mb = static_cast<double>(end - begin) / (1024.0 * 1024.0);
+    double t1 = parse(m, fmls1, begin, end, true);
+    double t2 = parse(m, fmls2, begin, end, false);
+    VERIFY(fmls1.size() == fmls2.size());
+    for (unsigned i = 0; i < fmls1.size(); ++i)
+        VERIFY(fmls1.get(i) == fmls2.get(i));
+    std::cout << name << " " << mb << " MB, " << fmls1.size() << " assertions\n"
+              << "  stream: " << t1 << " s, " << (t1 > 0 ? mb / t1 : 0) << " MB/s\n"
+              << "  memory: " << t2 << " s, " << (t2 > 0 ? mb / t2 : 0) << " MB/s\n";
+}
+
+void tst_smt2_throughput(char ** argv, int argc, int& i) {
+    bool has_file = false;
+    for (; i + 1 < argc && !strchr(argv[i + 1], '='); ++i) {
+        mapped_file f;
+        if (!f.open(argv[i + 1])) {
+            std::cout << "File not found " << argv[i + 1] << "\n";
+            continue;
+        }
+        has_file = true;
+        throughput(argv[i + 1], f.begin(), f.end());
+    }
+    if (!has_file) {
+        std::string s = mk_benchmark(1000, 50000);
+        throughput("generated", s.c_str(), s.c_str() + s.size());
+    }
+}
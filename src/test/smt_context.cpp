@@ -6,6 +6,54 @@ Copyright (c) 2015 Microsoft Corporation
 
 #include "smt/smt_context.h"
 #include "ast/reg_decl_plugins.h"
+#include "ast/arith_decl_plugin.h"
+
+static unsigned get_stat(smt::context & ctx, char const * key) {
+    statistics st;
+    ctx.collect_statistics(st);
+    for (unsigned i = 0; i < st.size(); ++i)
+        if (strcmp(st.get_key(i), key) == 0)
+            return st.get_uint_value(i);
+    return 0;
+}
+
+// repeated push/assert/check/pop cycles reuse the kept terms,
+// and the terms that remain internalized do not grow with the cycles.
+static void tst_keep_terms() {
+    smt_params params;
+    params.m_keep_terms = 4;
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    smt::context ctx(m, params);
+    sort * I = a.mk_int();
+    func_decl_ref f(m.mk_func_decl(symbol("f"), I, I), m);
+    app_ref x(m.mk_const(symbol("x"), I), m);
+    app_ref fx(m.mk_app(f, x.get()), m);
+    ctx.assert_expr(a.mk_ge(x, a.mk_int(0)));
+    VERIFY(ctx.check() == l_true);
+    unsigned num_enodes = 0;
+    for (unsigned i = 0; i < 50; ++i) {
+        ctx.push();
+        // f(x) is used in every cycle, f(i+1) only once.
+        app_ref fi(m.mk_app(f, a.mk_int(i + 1)), m);
+        ctx.assert_expr(a.mk_gt(fx, fi));
+        ctx.assert_expr(a.mk_gt(fi, a.mk_int(i)));
+        VERIFY(ctx.check() == l_true);
+        ctx.push();
+        ctx.assert_expr(a.mk_lt(fx, a.mk_int(i)));
+        VERIFY(ctx.check() == l_false);
+        ctx.pop(1);
+        ctx.pop(1);
+        if (i == 2)
+            num_enodes = ctx.enodes().size();
+        if (i > 2)
+            VERIFY(ctx.enodes().size() == num_enodes);
+    }
+    VERIFY(ctx.e_internalized(fx));
+    unsigned num_kept = get_stat(ctx, "kept terms");
+    VERIFY(0 < num_kept && num_kept <= params.m_keep_terms);
+}
 
 void tst_smt_context()
 {
@@ -32,4 +80,6 @@ void tst_smt_context()
     }
 
     ctx.check();
+
+    tst_keep_terms();
 }
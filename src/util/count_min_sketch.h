@@ -0,0 +1,77 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    count_min_sketch.h
+
+Abstract:
+
+    Approximate counting of hashed keys in bounded memory.
+
+    A count-min sketch keeps depth rows of 2^log_width counters.
+    A key increments one counter per row, and its count is estimated
+    as the minimum over the rows. Estimates never undercount.
+    Updates are conservative: only the counters that are equal to the
+    current estimate are incremented, which reduces overcounting.
+    The counters are allocated on the first increment.
+
+--*/
+#pragma once
+
+#include "util/hash.h"
+#include "util/vector.h"
+
+class count_min_sketch {
+    unsigned        m_mask;
+    unsigned        m_depth;
+    unsigned_vector m_counts; // row r occupies [r*(m_mask+1), (r+1)*(m_mask+1))
+
+    unsigned idx(unsigned h, unsigned row) const {
+        return row * (m_mask + 1) + (hash_u_u(h, row) & m_mask);
+    }
+
+public:
+    count_min_sketch(unsigned log_width = 12, unsigned depth = 4):
+        m_mask((1u << log_width) - 1),
+        m_depth(depth) {
+    }
+
+    unsigned estimate(unsigned h) const {
+        if (m_counts.empty())
+            return 0;
+        unsigned r = UINT_MAX;
+        for (unsigned row = 0; row < m_depth; ++row)
+            r = std::min(r, m_counts[idx(h, row)]);
+        return r;
+    }
+
+    /**
+       \brief increment the count of h and return the new estimate.
+    */
+    unsigned inc(unsigned h) {
+        if (m_counts.empty())
+            m_counts.resize(m_depth * (m_mask + 1), 0);
+        unsigned r = estimate(h);
+        if (r == UINT_MAX)
+            return r;
+        for (unsigned row = 0; row < m_depth; ++row) {
+            unsigned & c = m_counts[idx(h, row)];
+            if (c == r)
+                ++c;
+        }
+        return r + 1;
+    }
+
+    /**
+       \brief halve all counters, such that old counts age out.
+    */
+    void decay() {
+        for (unsigned & c : m_counts)
+            c >>= 1;
+    }
+
+    void reset() {
+        m_counts.fill(0);
+    }
+};
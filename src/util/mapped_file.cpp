@@ -0,0 +1,69 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    mapped_file.cpp
+
+Abstract:
+
+    Read-only view of the contents of a file.
+
+--*/
+#include <fstream>
+#include "util/mapped_file.h"
+
+#ifndef _WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+bool mapped_file::read(char const * file_name) {
+    std::ifstream in(file_name, std::ios::binary);
+    if (in.bad() || in.fail())
+        return false;
+    char buffer[1 << 16];
+    while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0)
+        m_buffer.append(static_cast<unsigned>(in.gcount()), buffer);
+    m_data = m_buffer.c_ptr();
+    m_size = m_buffer.size();
+    return true;
+}
+
+bool mapped_file::open(char const * file_name) {
+    close();
+#ifndef _WINDOWS
+    int fd = ::open(file_name, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void * p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+            madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+#endif
+            ::close(fd);
+            m_data   = static_cast<char const *>(p);
+            m_size   = static_cast<size_t>(st.st_size);
+            m_mapped = true;
+            return true;
+        }
+    }
+    ::close(fd);
+#endif
+    return read(file_name);
+}
+
+void mapped_file::close() {
+#ifndef _WINDOWS
+    if (m_mapped)
+        munmap(const_cast<char *>(m_data), m_size);
+#endif
+    m_buffer.finalize();
+    m_data   = nullptr;
+    m_size   = 0;
+    m_mapped = false;
+}
@@ -0,0 +1,44 @@
+/*++
+Copyright (c) 2020 Microsoft Corporation
+
+Module Name:
+
+    mapped_file.h
+
+Abstract:
+
+    Read-only view of the contents of a file.
+
+    On POSIX systems the file is memory mapped, such that parsers can
+    scan it in place without copying. Elsewhere, and for files that
+    cannot be mapped, the contents are read into a buffer.
+
+--*/
+#pragma once
+
+#include <cstddef>
+#include "util/vector.h"
+
+class mapped_file {
+    char const *  m_data;
+    size_t        m_size;
+    bool          m_mapped;
+    svector<char> m_buffer;
+
+    bool read(char const * file_name);
+
+public:
+    mapped_file(): m_data(nullptr), m_size(0), m_mapped(false) {}
+    ~mapped_file() { close(); }
+
+    /**
+       \brief make the contents of the given file available.
+       Return false if the file cannot be opened.
+    */
+    bool open(char const * file_name);
+    void close();
+
+    char const * begin() const { return m_data; }
+    char const * end() const { return m_data + m_size; }
+    size_t size() const { return m_size; }
+};
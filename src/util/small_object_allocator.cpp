@@ -23,33 +23,37 @@ Revision History:
 #include "util/debug.h"
 #include "util/util.h"
 #include "util/vector.h"
+#include "util/statistics.h"
+#include<algorithm>
 #include<iomanip>
+#if defined(__linux__)
+#include<sys/mman.h>
+#endif
 
 small_object_allocator::small_object_allocator(char const * id) {
     for (unsigned i = 0; i < NUM_SLOTS; i++) {
         m_chunks[i] = nullptr;
         m_free_list[i] = nullptr;
+        m_num_free[i] = 0;
+        m_num_chunks[i] = 0;
     }
     DEBUG_CODE({
         m_id = id;
     });
     m_alloc_size = 0;
+    m_arenas = nullptr;
+    m_num_arenas = 0;
+    m_num_released = 0;
+    m_huge_pages = false;
 }
 
 small_object_allocator::~small_object_allocator() {
-    for (unsigned i = 0; i < NUM_SLOTS; i++) {
-        chunk * c = m_chunks[i];
-        while (c) {
-            chunk * next = c->m_next;
-            dealloc(c);
-            c = next;
-        }
-    }
     DEBUG_CODE({
         if (m_alloc_size > 0) {
             std::cerr << "Memory leak detected for small object allocator '" << m_id << "'. " << m_alloc_size << " bytes leaked" << std::endl;
         }
     });
+    reset();
 }
 
 void small_object_allocator::reset() {
@@ -57,15 +61,99 @@ void small_object_allocator::reset() {
         chunk * c = m_chunks[i];
         while (c) {
             chunk * next = c->m_next;
-            dealloc(c);
+            del_chunk(c);
             c = next;
         }
         m_chunks[i] = nullptr;
         m_free_list[i] = nullptr;
+        m_num_free[i] = 0;
+        m_num_chunks[i] = 0;
     }
+    SASSERT(m_arenas == nullptr);
     m_alloc_size = 0;
 }
 
+void small_object_allocator::push_arena(arena * a) {
+    if (m_arenas == nullptr) {
+        a->m_next = a->m_prev = a;
+    }
+    else {
+        a->m_next = m_arenas;
+        a->m_prev = m_arenas->m_prev;
+        m_arenas->m_prev->m_next = a;
+        m_arenas->m_prev = a;
+    }
+    m_arenas = a;
+}
+
+void small_object_allocator::unlink_arena(arena * a) {
+    if (a->m_next == a) {
+        m_arenas = nullptr;
+        return;
+    }
+    a->m_prev->m_next = a->m_next;
+    a->m_next->m_prev = a->m_prev;
+    if (m_arenas == a)
+        m_arenas = a->m_next;
+}
+
+small_object_allocator::chunk * small_object_allocator::mk_chunk() {
+    if (!m_huge_pages)
+        return alloc(chunk);
+    if (m_arenas == nullptr || is_full(m_arenas)) {
+        arena * a = alloc(arena);
+        a->m_free = nullptr;
+        a->m_num_carved = 0;
+        a->m_num_used = 0;
+        a->m_mem = static_cast<char*>(memory::allocate(ARENA_SIZE));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        // only the huge pages that lie entirely within the arena can be advised.
+        uintptr_t begin = (reinterpret_cast<uintptr_t>(a->m_mem) + HUGE_PAGE_SIZE - 1) & ~static_cast<uintptr_t>(HUGE_PAGE_SIZE - 1);
+        uintptr_t end   = (reinterpret_cast<uintptr_t>(a->m_mem) + ARENA_SIZE) & ~static_cast<uintptr_t>(HUGE_PAGE_SIZE - 1);
+        if (begin < end)
+            madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+#endif
+        push_arena(a);
+        m_num_arenas++;
+    }
+    arena * a = m_arenas;
+    void * mem;
+    if (a->m_free != nullptr) {
+        mem = a->m_free;
+        a->m_free = a->m_free->m_next;
+    }
+    else {
+        mem = reinterpret_cast<chunk*>(a->m_mem) + a->m_num_carved;
+        a->m_num_carved++;
+    }
+    a->m_num_used++;
+    chunk * c = new (mem) chunk();
+    c->m_arena = a;
+    if (is_full(a))
+        m_arenas = a->m_next; // rotate the full arena to the back
+    return c;
+}
+
+void small_object_allocator::del_chunk(chunk * c) {
+    arena * a = c->m_arena;
+    if (a == nullptr) {
+        dealloc(c);
+        return;
+    }
+    SASSERT(a->m_num_used > 0);
+    a->m_num_used--;
+    unlink_arena(a);
+    if (a->m_num_used == 0) {
+        memory::deallocate(a->m_mem);
+        dealloc(a);
+        m_num_arenas--;
+        return;
+    }
+    c->m_next = a->m_free;
+    a->m_free = c;
+    push_arena(a);
+}
+
 #define MASK ((1 << PTR_ALIGNMENT) - 1)
 
 
@@ -91,6 +179,7 @@ void small_object_allocator::deallocate(size_t size, void * p) {
     SASSERT(slot_id < NUM_SLOTS);
     *(reinterpret_cast<void**>(p)) = m_free_list[slot_id];
     m_free_list[slot_id] = p;
+    m_num_free[slot_id]++;
 }
 
 
@@ -117,6 +206,7 @@ void * small_object_allocator::allocate(size_t size) {
     if (m_free_list[slot_id] != nullptr) {
         void * r = m_free_list[slot_id];
         m_free_list[slot_id] = *(reinterpret_cast<void **>(r));
+        m_num_free[slot_id]--;
         return r;
     }
     chunk * c = m_chunks[slot_id]; 
@@ -130,9 +220,10 @@ void * small_object_allocator::allocate(size_t size) {
             return r;
         }
     }
-    chunk * new_c = alloc(chunk);
+    chunk * new_c = mk_chunk();
     new_c->m_next = c;
     m_chunks[slot_id] = new_c;
+    m_num_chunks[slot_id]++;
     void * r = new_c->m_curr;
     new_c->m_curr += size;
     return r;
@@ -140,29 +231,36 @@ void * small_object_allocator::allocate(size_t size) {
 
 size_t small_object_allocator::get_wasted_size() const {
     size_t r = 0;
-    for (unsigned slot_id = 0; slot_id < NUM_SLOTS; slot_id++) {
-        size_t slot_obj_size = slot_id << PTR_ALIGNMENT;
-        void ** ptr = reinterpret_cast<void **>(const_cast<small_object_allocator*>(this)->m_free_list[slot_id]);
-        while (ptr != nullptr) {
-            r += slot_obj_size;
-            ptr = reinterpret_cast<void**>(*ptr);
-        }
-    }
+    for (unsigned slot_id = 0; slot_id < NUM_SLOTS; slot_id++) 
+        r += m_num_free[slot_id] * (slot_id << PTR_ALIGNMENT);
     return r;
 }
 
 size_t small_object_allocator::get_num_free_objs() const {
     size_t r = 0;
-    for (unsigned slot_id = 0; slot_id < NUM_SLOTS; slot_id++) {
-        void ** ptr = reinterpret_cast<void **>(const_cast<small_object_allocator*>(this)->m_free_list[slot_id]);
-        while (ptr != nullptr) {
-            r ++;
-            ptr = reinterpret_cast<void**>(*ptr);
-        }
+    for (unsigned slot_id = 0; slot_id < NUM_SLOTS; slot_id++) 
+        r += m_num_free[slot_id];
+    return r;
+}
+
+size_t small_object_allocator::get_num_objs() const {
+    size_t r = 0;
+    for (unsigned slot_id = 1; slot_id < NUM_SLOTS; slot_id++) {
+        size_t obj_size = slot_id << PTR_ALIGNMENT;
+        for (chunk * c = m_chunks[slot_id]; c != nullptr; c = c->m_next) 
+            r += (c->m_curr - c->m_data) / obj_size;
+        r -= m_num_free[slot_id];
     }
     return r;
 }
 
+unsigned small_object_allocator::get_num_chunks() const {
+    unsigned r = 0;
+    for (unsigned slot_id = 0; slot_id < NUM_SLOTS; slot_id++) 
+        r += m_num_chunks[slot_id];
+    return r;
+}
+
 template<typename T>
 struct ptr_lt {
     bool operator()(T * p1, T * p2) const { return p1 < p2; }
@@ -175,69 +273,117 @@ void small_object_allocator::consolidate() {
                verbose_stream() << "(allocator-consolidate :wasted-size " << get_wasted_size()
                << " :memory " << std::fixed << std::setprecision(2) << 
                static_cast<double>(memory::get_allocation_size())/static_cast<double>(1024*1024) << ")" << std::endl;);
+    release_free_chunks(0);
+    IF_VERBOSE(CONSOLIDATE_VB_LVL, 
+               verbose_stream() << "(end-allocator-consolidate :wasted-size " << get_wasted_size() 
+               << " :memory " << std::fixed << std::setprecision(2) 
+               << static_cast<double>(memory::get_allocation_size())/static_cast<double>(1024*1024) << ")" << std::endl;);
+}
+
+unsigned small_object_allocator::release_free_chunks(unsigned min_free_pct) {
+    unsigned num_released = 0;
     ptr_vector<chunk> chunks;
-    ptr_vector<char> free_objs;
+    unsigned_vector   num_free;
+    // index of the chunk in the sorted chunks that contains p
+    auto find = [&](void * p) {
+        auto it = std::upper_bound(chunks.begin(), chunks.end(), static_cast<chunk*>(p), ptr_lt<chunk>());
+        SASSERT(it != chunks.begin());
+        return static_cast<unsigned>(it - chunks.begin()) - 1;
+    };
     for (unsigned slot_id = 1; slot_id < NUM_SLOTS; slot_id++) {
         if (m_free_list[slot_id] == nullptr)
             continue;
+        size_t obj_size = slot_id << PTR_ALIGNMENT;
+        if (100 * m_num_free[slot_id] * obj_size < static_cast<size_t>(min_free_pct) * m_num_chunks[slot_id] * CHUNK_SIZE)
+            continue;
         chunks.reset();
-        free_objs.reset();
-        chunk * c = m_chunks[slot_id];
-        while (c != nullptr) {
+        for (chunk * c = m_chunks[slot_id]; c != nullptr; c = c->m_next) 
             chunks.push_back(c);
-            c = c->m_next;
-        }
-        char * ptr = static_cast<char*>(m_free_list[slot_id]);
-        while (ptr != nullptr) {
-            free_objs.push_back(ptr);
-            ptr = *(reinterpret_cast<char**>(ptr));
+        std::sort(chunks.begin(), chunks.end(), ptr_lt<chunk>());
+        num_free.reset();
+        num_free.resize(chunks.size(), 0);
+        for (void * p = m_free_list[slot_id]; p != nullptr; p = *(reinterpret_cast<void**>(p))) 
+            num_free[find(p)]++;
+        bool found = false;
+        for (unsigned i = 0; i < chunks.size(); i++) {
+            if (num_free[i] == static_cast<unsigned>((chunks[i]->m_curr - chunks[i]->m_data) / obj_size)) {
+                num_free[i] = UINT_MAX;
+                found = true;
+            }
         }
-        unsigned obj_size = slot_id << PTR_ALIGNMENT;
-        unsigned num_objs_per_chunk = CHUNK_SIZE / obj_size;
-        if (free_objs.size() < num_objs_per_chunk)
+        if (!found)
             continue;
-        SASSERT(!chunks.empty());
-        std::sort(chunks.begin(), chunks.end(), ptr_lt<chunk>());
-        std::sort(free_objs.begin(), free_objs.end(), ptr_lt<char>());
-        chunk *   last_chunk = nullptr;
-        void * last_free_obj = nullptr;
-        unsigned chunk_idx = 0;
-        unsigned obj_idx   = 0;
-        unsigned num_chunks = chunks.size();
-        unsigned num_objs   = free_objs.size();
-        while (chunk_idx < num_chunks) {
-            chunk * curr_chunk = chunks[chunk_idx];
-            char *  curr_begin = curr_chunk->m_data;
-            char *  curr_end   = curr_begin + CHUNK_SIZE;
-            unsigned num_free_in_chunk = 0;
-            unsigned saved_obj_idx = obj_idx;
-            while (obj_idx < num_objs) {
-                char * free_obj = free_objs[obj_idx];
-                if (free_obj > curr_end)
-                    break;
-                obj_idx++;
-                num_free_in_chunk++;
+        // drop the free objects of released chunks, keeping the order of the remaining ones.
+        void ** tail = &m_free_list[slot_id];
+        void *  p    = m_free_list[slot_id];
+        m_num_free[slot_id] = 0;
+        while (p != nullptr) {
+            void * next = *(reinterpret_cast<void**>(p));
+            if (num_free[find(p)] != UINT_MAX) {
+                *tail = p;
+                tail = reinterpret_cast<void**>(p);
+                m_num_free[slot_id]++;
             }
-            if (num_free_in_chunk == num_objs_per_chunk) {
-                dealloc(curr_chunk);
+            p = next;
+        }
+        *tail = nullptr;
+        chunk ** c_tail = &m_chunks[slot_id];
+        chunk *  c      = m_chunks[slot_id];
+        while (c != nullptr) {
+            chunk * next = c->m_next;
+            if (num_free[find(c)] == UINT_MAX) {
+                del_chunk(c);
+                m_num_chunks[slot_id]--;
+                num_released++;
             }
             else {
-                curr_chunk->m_next = last_chunk;
-                last_chunk = curr_chunk;
-                for (unsigned i = saved_obj_idx; i < obj_idx; i++) {
-                    // relink objects
-                    void * free_obj = free_objs[i];
-                    *(reinterpret_cast<void**>(free_obj)) = last_free_obj;
-                    last_free_obj = free_obj;
-                }
+                *c_tail = c;
+                c_tail = &c->m_next;
             }
-            chunk_idx++;
+            c = next;
         }
-        m_chunks[slot_id]    = last_chunk;
-        m_free_list[slot_id] = last_free_obj;
+        *c_tail = nullptr;
     }
-    IF_VERBOSE(CONSOLIDATE_VB_LVL, 
-               verbose_stream() << "(end-allocator-consolidate :wasted-size " << get_wasted_size() 
-               << " :memory " << std::fixed << std::setprecision(2) 
-               << static_cast<double>(memory::get_allocation_size())/static_cast<double>(1024*1024) << ")" << std::endl;);
+    m_num_released += num_released;
+    return num_released;
+}
+
+/**
+   \brief size classes are reported in power of two buckets.
+*/
+char const * small_object_allocator::bucket_key(size_t obj_size) {
+    static char const * keys[] = {
+        "memory objects up to 16 bytes",
+        "memory objects up to 32 bytes",
+        "memory objects up to 64 bytes",
+        "memory objects up to 128 bytes",
+        "memory objects up to 256 bytes"
+    };
+    unsigned i = 0;
+    while ((16u << i) < obj_size)
+        ++i;
+    return keys[i];
+}
+
+void small_object_allocator::collect_statistics(statistics & st) const {
+    auto mb = [](size_t sz) { return static_cast<double>((100*sz)/(1024*1024))/100.0; };
+    size_t num_objs = 0;
+    for (unsigned slot_id = 1; slot_id < NUM_SLOTS; slot_id++) {
+        size_t obj_size = slot_id << PTR_ALIGNMENT;
+        size_t n = 0;
+        for (chunk * c = m_chunks[slot_id]; c != nullptr; c = c->m_next) 
+            n += (c->m_curr - c->m_data) / obj_size;
+        n -= m_num_free[slot_id];
+        if (n > 0)
+            st.update(bucket_key(obj_size), static_cast<unsigned>(n));
+        num_objs += n;
+    }
+    st.update("memory small objects", static_cast<unsigned>(num_objs));
+    st.update("memory free objects", static_cast<unsigned>(get_num_free_objs()));
+    st.update("memory chunks", get_num_chunks());
+    if (m_num_released > 0)
+        st.update("memory released chunks", m_num_released);
+    if (m_num_arenas > 0)
+        st.update("memory arenas", m_num_arenas);
+    st.update("memory wasted size", mb(get_wasted_size()));
 }
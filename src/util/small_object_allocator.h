@@ -22,22 +22,50 @@ Revision History:
 #include "util/machine.h"
 #include "util/debug.h"
 
+class statistics;
+
 class small_object_allocator {
-    static const unsigned CHUNK_SIZE     = (8192 - sizeof(void*)*2);
+    static const unsigned CHUNK_SIZE     = (8192 - sizeof(void*)*3);
     static const unsigned SMALL_OBJ_SIZE = 256;
     static const unsigned NUM_SLOTS      = (SMALL_OBJ_SIZE >> PTR_ALIGNMENT);
+    static const unsigned ARENA_SIZE     = (1 << 22);
+    static const unsigned HUGE_PAGE_SIZE = (1 << 21);
+    struct arena;
     struct chunk {
         chunk * m_next;
         char  * m_curr;
+        arena * m_arena;  // arena containing the chunk, nullptr if the chunk was allocated on its own
         char    m_data[CHUNK_SIZE];
-        chunk():m_curr(m_data) {}
+        chunk():m_curr(m_data), m_arena(nullptr) {}
+    };
+    static const unsigned CHUNKS_PER_ARENA = ARENA_SIZE / sizeof(chunk);
+    // arenas are kept in a circular list, where arenas with available chunks precede full arenas.
+    struct arena {
+        arena *  m_prev;
+        arena *  m_next;
+        chunk *  m_free;        // released chunks
+        unsigned m_num_carved;  // chunks carved from m_mem
+        unsigned m_num_used;
+        char  *  m_mem;
     };
     chunk *     m_chunks[NUM_SLOTS];
     void  *     m_free_list[NUM_SLOTS];
+    size_t      m_num_free[NUM_SLOTS];    // length of m_free_list
+    unsigned    m_num_chunks[NUM_SLOTS];
     size_t      m_alloc_size;
+    arena *     m_arenas;
+    unsigned    m_num_arenas;
+    unsigned    m_num_released;
+    bool        m_huge_pages;
 #ifdef Z3DEBUG
     char const * m_id;
 #endif
+    chunk * mk_chunk();
+    void del_chunk(chunk * c);
+    void push_arena(arena * a);
+    void unlink_arena(arena * a);
+    static bool is_full(arena const * a) { return a->m_free == nullptr && a->m_num_carved == CHUNKS_PER_ARENA; }
+    static char const * bucket_key(size_t obj_size);
 public:
     small_object_allocator(char const * id = "unknown");
     ~small_object_allocator();
@@ -47,7 +75,26 @@ public:
     size_t get_allocation_size() const { return m_alloc_size; }
     size_t get_wasted_size() const;
     size_t get_num_free_objs() const;
+    size_t get_num_objs() const;
+    unsigned get_num_chunks() const;
     void consolidate();
+
+    /**
+       \brief release chunks whose objects are all free.
+       Only size classes where at least min_free_pct percent of the chunk memory
+       is on the free list are inspected. Unlike consolidate(), the free lists
+       are not sorted. Return the number of released chunks.
+    */
+    unsigned release_free_chunks(unsigned min_free_pct = 25);
+
+    /**
+       \brief carve new chunks from 4MB arenas that are advised to be backed by
+       transparent huge pages where the platform supports it.
+       An arena is returned to the system when all its chunks are released.
+    */
+    void set_huge_pages(bool f) { m_huge_pages = f; }
+
+    void collect_statistics(statistics & st) const;
 };
 
 inline void * operator new(size_t s, small_object_allocator & r) { return r.allocate(s); }